@@ -2,16 +2,57 @@
 #define MIN_SUM_HXX
 
 #include <tuple>
+#include <limits>
+#include <iterator>
+#include <algorithm>
 #include <cassert>
 
 namespace tropical_convolution {
 
+      namespace detail {
+
+         // largest value of the given type. Used for initializing outputs, also for types without infinity, e.g. integers.
+         // For integers it is not absorbing: as an input value it is added like any other and the sum overflows, see sums_fit.
+         template<typename VALUE_TYPE>
+         constexpr VALUE_TYPE infinity()
+         {
+            return std::numeric_limits<VALUE_TYPE>::has_infinity ? std::numeric_limits<VALUE_TYPE>::infinity() : std::numeric_limits<VALUE_TYPE>::max();
+         }
+
+         // integer sums a[i] + b[j] are not guarded, hence max(a) + max(b) and min(a) + min(b) must be representable. Always true for floating point values.
+         // Checked by assertions, it takes linear time.
+         template<typename ITERATOR_1, typename ITERATOR_2>
+         bool sums_fit(ITERATOR_1 a_begin, ITERATOR_1 a_end, ITERATOR_2 b_begin, ITERATOR_2 b_end)
+         {
+            using VALUE_TYPE = typename std::iterator_traits<ITERATOR_1>::value_type;
+            if(!std::numeric_limits<VALUE_TYPE>::is_integer || a_begin == a_end || b_begin == b_end) { return true; }
+            const auto a_range = std::minmax_element(a_begin, a_end);
+            const auto b_range = std::minmax_element(b_begin, b_end);
+            const VALUE_TYPE zero = VALUE_TYPE(0);
+            const bool max_fits = !(zero < *b_range.second) || *a_range.second <= std::numeric_limits<VALUE_TYPE>::max() - *b_range.second;
+            const bool min_fits = !(*b_range.first < zero) || *a_range.first >= std::numeric_limits<VALUE_TYPE>::lowest() - *b_range.first;
+            return max_fits && min_fits;
+         }
+
+         // output iterator discarding everything assigned to it, used when optimal indices are not recorded.
+         struct null_iterator {
+            struct null_value {
+               template<typename T>
+               null_value& operator=(const T&) { return *this; }
+            };
+            null_value operator*() const { return null_value(); }
+            null_value operator[](std::size_t) const { return null_value(); }
+         };
+
+      } // end namespace detail
+
+      // min { a[i] + b[sum-i] }. Integer input must leave headroom for the sums, see detail::sums_fit.
       template<typename ITERATOR_1, typename ITERATOR_2>
       typename std::iterator_traits<ITERATOR_1>::value_type min_sum(ITERATOR_1 a_begin, ITERATOR_1 a_end, ITERATOR_2 b_begin, ITERATOR_2 b_end, const std::size_t sum)
       {
          using VALUE_TYPE = typename std::iterator_traits<ITERATOR_1>::value_type;
          static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<ITERATOR_2>::value_type>::value, "iterators must have same value type");
-         VALUE_TYPE val = std::numeric_limits<VALUE_TYPE>::infinity();
+         VALUE_TYPE val = detail::infinity<VALUE_TYPE>();
 
          const auto a_size = std::distance(a_begin, a_end);
          assert(a_size > 1);
@@ -26,14 +67,14 @@ namespace tropical_convolution {
          return val;
       }
 
-      // find out the two indices (left,right) whose sum is minimal
+      // find out the two indices (left,right) whose sum is minimal. Integer input must leave headroom for the sums, see detail::sums_fit.
       template<typename ITERATOR_1, typename ITERATOR_2>
       std::tuple<typename std::iterator_traits<ITERATOR_1>::value_type,std::size_t,std::size_t> 
       arg_min_sum(ITERATOR_1 a_begin, ITERATOR_1 a_end, ITERATOR_2 b_begin, ITERATOR_2 b_end, const std::size_t sum)
       {
          using VALUE_TYPE = typename std::iterator_traits<ITERATOR_1>::value_type;
          static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<ITERATOR_2>::value_type>::value, "iterators must have same value type");
-         VALUE_TYPE val = std::numeric_limits<VALUE_TYPE>::infinity();
+         VALUE_TYPE val = detail::infinity<VALUE_TYPE>();
 
          std::size_t a = std::numeric_limits<std::size_t>::max();
          std::size_t b = std::numeric_limits<std::size_t>::max();
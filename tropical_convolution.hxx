@@ -5,42 +5,164 @@
 #include <cassert>
 #include "tropical_convolution_naive.hxx"
 #include "tropical_convolution_bussieck.hxx"
+#include "tropical_convolution_convex.hxx"
 #include "min_sum.hxx"
 
-// perform min convolution. Choose automatically betweeen the naive version which is fast on small inputs and the method by Bussieck et al tends to be faster for larger input
+// perform min convolution. Choose automatically betweeen the naive version which is fast on small inputs and the method by Bussieck et al tends to be faster for larger input.
+// Unless the input is small, convex or concave operands are detected first and handled by the linear time algorithms in tropical_convolution_convex.hxx.
 
 namespace tropical_convolution{
 
       // automatically choose between naive and efficient version of min convolution
       // when more elements than indicated by threshold need to be computed, use heuristic, otherwise use naive implementation.
-      // a good value can be gleaned from the results of the benchmark program.
+      // a good value can be gleaned from the results of the benchmark program. Values measured on the host by min_conv_calibrate take precedence.
       static const std::size_t min_conv_threshold = 160; // break even value of the two implementations gleaned from running tropical_convolution_benchmark
+      // break even values when min_conv_naive can use its vectorized kernel, measured by min_conv_calibrate on equally long uniform random operands on an AVX-512 host,
+      // once limited to AVX2. A vector holds twice as many floats as doubles. For int32 the method of Bussieck et al enumerates sums with the radix queue and wins earlier.
+      static const std::size_t min_conv_threshold_avx2_float = 46000;
+      static const std::size_t min_conv_threshold_avx2_double = 21000;
+      static const std::size_t min_conv_threshold_avx2_int32 = 21000;
+      static const std::size_t min_conv_threshold_avx512_float = 131000;
+      static const std::size_t min_conv_threshold_avx512_double = 42000;
+      static const std::size_t min_conv_threshold_avx512_int32 = 36000;
+
+      // check whether the input is convex or concave when at least min_conv_threshold values are computed. Define TROPICAL_CONVOLUTION_NO_STRUCTURE_DETECTION to skip the check.
+#ifdef TROPICAL_CONVOLUTION_NO_STRUCTURE_DETECTION
+      static const bool min_conv_detect_structure = false;
+#else
+      static const bool min_conv_detect_structure = true;
+#endif
+
+      // result size above which SMAWK beats the vectorized naive implementation when only one input is convex.
+      static const std::size_t min_conv_smawk_threshold = 4096;
+
+      namespace detail {
+
+         // tuned value if available, see tropical_convolution_tuning.hxx
+         template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+         std::size_t naive_threshold(const std::size_t a_size, const std::size_t b_size)
+         {
+            using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+            const auto level = effective_simd_level<INPUT_ITERATOR_1, INPUT_ITERATOR_2, OUTPUT_ITERATOR>();
+            const auto& p = tuned_parameters<VALUE_TYPE>(level, a_size, b_size);
+            if(p.naive_threshold > 0) {
+               return p.naive_threshold;
+            }
+            // the vectorized kernel is only used for float, double and int32
+            const bool is_float = std::is_same<VALUE_TYPE, float>::value;
+            const bool is_double = std::is_same<VALUE_TYPE, double>::value;
+            switch(level) {
+               case simd_level::avx512: return is_float ? min_conv_threshold_avx512_float : is_double ? min_conv_threshold_avx512_double : min_conv_threshold_avx512_int32;
+               case simd_level::avx2: return is_float ? min_conv_threshold_avx2_float : is_double ? min_conv_threshold_avx2_double : min_conv_threshold_avx2_int32;
+               default: return min_conv_threshold;
+            }
+         }
+
+         template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+         void min_conv_naive_or_arg_min(
+             INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+             OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+         {
+            min_conv_naive(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+         }
+
+         // indices are not needed, use the cheaper version
+         template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL>
+         void min_conv_naive_or_arg_min(
+             INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+             OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, null_iterator)
+         {
+            min_conv_naive(a_begin, a_end, b_begin, b_end, result_begin, result_end);
+         }
+
+         // choose the algorithm for min_conv. naive() and bussieck() run the respective method on the same arguments.
+         template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename NAIVE, typename BUSSIECK>
+         void min_conv_dispatch(
+             INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+             OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, NAIVE naive, BUSSIECK bussieck)
+         {
+            assert(sums_fit(a_begin, a_end, b_begin, b_end));
+            const auto result_size = std::distance(result_begin, result_end);
+            const auto naive_threshold = detail::naive_threshold<INPUT_ITERATOR_1, INPUT_ITERATOR_2, OUTPUT_ITERATOR_VAL>(std::distance(a_begin, a_end), std::distance(b_begin, b_end));
+            if(min_conv_detect_structure && result_size >= min_conv_threshold) {
+               const bool use_smawk = result_size >= std::min(naive_threshold, min_conv_smawk_threshold);
+               if(min_conv_structured(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, use_smawk)) { return; }
+            }
+            if(result_size < naive_threshold) {
+               naive();
+            } else {
+               bussieck();
+            }
+         }
+
+         template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename BUSSIECK>
+         void min_conv_dispatch(
+             INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+             OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, BUSSIECK bussieck)
+         {
+            min_conv_dispatch(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, [&]() {
+               min_conv_naive_or_arg_min(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+            }, bussieck);
+         }
+
+      } // end namespace detail
+
+      // the workspace is used by the method of Bussieck et al and can be reused across calls.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR, typename VALUE_TYPE>
+      void min_conv(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_workspace<VALUE_TYPE>& workspace)
+      {
+         detail::min_conv_dispatch(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator(), [&]() {
+            min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end, workspace);
+         });
+      }
 
       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
       void min_conv(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end)
       {
-         const auto result_size = std::distance(result_begin, result_end);
-         if(result_size < min_conv_threshold) {
-            return min_conv_naive(a_begin, a_end, b_begin, b_end, result_begin, result_end);
-         } else {
-            return min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end);
-         }
+         min_conv_workspace<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type> workspace;
+         min_conv(a_begin, a_end, b_begin, b_end, result_begin, result_end, workspace);
       }
 
       // additionally return the index coming from the first vector for the optimum convolution. 
       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
       void min_conv(
           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, 
-          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type>& workspace)
       {
-         const auto result_size = std::distance(result_begin, result_end);
-         if(result_size < min_conv_threshold) {
-            return min_conv_naive(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
-         } else {
-            return min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
-         }
+         detail::min_conv_dispatch(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, [&]() {
+            min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, workspace);
+         });
       } 
 
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, 
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+      {
+         min_conv_workspace<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type> workspace;
+         min_conv(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, workspace);
+      }
+
+      // convolve with a prepared operand, whose sorted indices are reused by the method of Bussieck et al.
+      template<typename INPUT_ITERATOR_1, typename OUTPUT_ITERATOR, typename VALUE_TYPE>
+      void min_conv(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const prepared_operand<VALUE_TYPE>& b, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_workspace<VALUE_TYPE>& workspace)
+      {
+         detail::min_conv_dispatch(a_begin, a_end, b.begin(), b.end(), result_begin, result_end, detail::null_iterator(), [&]() {
+            min_conv_Bussieck_et_al(a_begin, a_end, b, result_begin, result_end, workspace);
+         });
+      }
+
+      template<typename INPUT_ITERATOR_1, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename VALUE_TYPE>
+      void min_conv(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const prepared_operand<VALUE_TYPE>& b,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, min_conv_workspace<VALUE_TYPE>& workspace)
+      {
+         detail::min_conv_dispatch(a_begin, a_end, b.begin(), b.end(), result_begin, result_end, result_index_a_begin, [&]() {
+            min_conv_Bussieck_et_al(a_begin, a_end, b, result_begin, result_end, result_index_a_begin, workspace);
+         });
+      }
+
 } // end namespace tropical_convolution
 
 #endif // TROPICAL_CONVOLUTION_HXX
@@ -0,0 +1,268 @@
+#ifndef TROPICAL_CONVOLUTION_APPROX_HXX
+#define TROPICAL_CONVOLUTION_APPROX_HXX
+
+#include "tropical_convolution.hxx"
+#include <vector>
+#include <array>
+#include <tuple>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include <cassert>
+
+// approximate min convolution for floating point input, with a relative error of at most epsilon or an absolute error of at most delta.
+// Both operands are sorted once. Every output visits its pairs from the smallest elements of a and b upwards, until the pairs not yet visited cannot improve the best sum by more than the tolerance.
+// Outputs that are not settled before the scan costs as much as the naive kernel for them are computed by the naive kernel, together with the other outputs of their vector. Convex, concave and very small inputs are computed exactly as by min_conv,
+// and the naive kernel is used right away when sorting alone would cost more than min_conv_approx_max_overhead of it.
+// A sample of outputs is approximated first. When it predicts no gain over the cheaper exact method, or a run of outputs is not settled, the result is computed exactly instead,
+// by the naive method or by the method of Bussieck et al, whichever the sample predicts to be cheaper. The latter is quadratic with a large constant on e.g. sorted input.
+// The scan does not use the heap of Bussieck et al, since inputs with many equal or nearly equal values make it quadratic, while for them the tolerance is reached after few pairs.
+// Every output is the sum a[i] + b[k-i] of the returned index, so results never undercut the exact values.
+
+namespace tropical_convolution {
+
+  // number of evenly spaced outputs approximated for predicting the runtime.
+  static const std::size_t min_conv_approx_probes = 64;
+  // cost of visiting a pair in sorted order relative to a pair of the vectorized naive kernel, measured with AVX-512 on uniform random double input.
+  // A vector holds 8/sizeof(VALUE_TYPE) times as many pairs of other types, the costs are scaled accordingly.
+  static const double min_conv_approx_visit_cost = 48.0;
+  // cost of the method of Bussieck et al per pair that settling an output exactly visits in sorted order, in the same units.
+  static const double min_conv_approx_heap_cost = 32.0;
+  // cost of sorting per element and binary digit of the operand size, in the same units.
+  static const double min_conv_approx_sort_cost = 90.0;
+  // operands are only sorted if that costs at most this fraction of the naive kernel, which bounds the time lost when the sample then chooses the naive kernel.
+  static const double min_conv_approx_max_overhead = 0.25;
+  // the exact method is used for the remaining outputs after this many consecutive outputs are not settled.
+  static const std::size_t min_conv_approx_max_failures = 32;
+
+  namespace detail {
+
+       // pairs of the vectorized naive kernel per pair of double, the unit of the costs above.
+       template<typename VALUE_TYPE>
+       constexpr double approx_lanes() { return 8.0 / sizeof(VALUE_TYPE); }
+
+       // outputs of one AVX-512 vector. The naive kernel computes them together, a single output costs as much as the whole block.
+       template<typename VALUE_TYPE>
+       constexpr std::size_t approx_block_size() { return 64 / sizeof(VALUE_TYPE); }
+
+       // stop when best is within a factor of 1+epsilon of the lower bound, for non-negative values.
+       struct relative_tolerance {
+         double epsilon;
+         template<typename VALUE_TYPE>
+         bool operator()(const VALUE_TYPE best, const VALUE_TYPE lower_bound) const { return best <= (1.0 + epsilon) * lower_bound; }
+       };
+
+       // stop when best exceeds the lower bound by at most delta.
+       struct additive_tolerance {
+         double delta;
+         template<typename VALUE_TYPE>
+         bool operator()(const VALUE_TYPE best, const VALUE_TYPE lower_bound) const { return best <= lower_bound + delta; }
+       };
+
+       // approximate c[k] by visiting the pairs summing to k in the sorted orders of a and b simultaneously. After visiting the r smallest elements of a and of b,
+       // every pair not visited yet has a sum of at least idx_a[r].val + idx_b[r].val, and the scan stops once the best sum found is within the tolerance of this bound.
+       // Visiting pairs in sorted order is much slower than the naive kernel. With rank_cost the cost of one rank in pairs of the naive kernel,
+       // give up and return false once the ranks visited cost as much as the naive kernel for all pairs of k. The number of ranks visited is added to nr_visited.
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename VALUE_TYPE, typename TOLERANCE>
+       std::tuple<bool, VALUE_TYPE, std::size_t> arg_min_sum_approx(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_a,
+           INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_b,
+           const std::size_t k, TOLERANCE tolerance, const double rank_cost, std::size_t& nr_visited)
+       {
+         const std::size_t a_size = std::distance(a_begin, a_end);
+         const std::size_t b_size = std::distance(b_begin, b_end);
+         const std::size_t i_begin = k+1 > b_size ? k+1 - b_size : 0;
+         const std::size_t i_end = std::min(k+1, a_size);
+         const std::size_t nr_pairs = i_end - i_begin;
+
+         VALUE_TYPE best = detail::infinity<VALUE_TYPE>();
+         std::size_t best_i = i_begin;
+         auto visit = [&](const std::size_t i) {
+           const VALUE_TYPE val = a_begin[i] + b_begin[k-i];
+           if(val < best) {
+             best = val;
+             best_i = i;
+           }
+         };
+
+         const std::size_t nr_ranks = std::min(a_size, b_size);
+         for(std::size_t r=0; r<nr_ranks; ++r) {
+           ++nr_visited;
+           const std::size_t i = idx_a[r].idx;
+           if(i >= i_begin && i < i_end) { visit(i); }
+           const std::size_t j = idx_b[r].idx;
+           if(j <= k && k-j < a_size) { visit(k-j); }
+           if(r+1 == nr_ranks || tolerance(best, VALUE_TYPE(idx_a[r+1].val + idx_b[r+1].val))) { break; }
+           if(double(r+1) * rank_cost >= double(nr_pairs)) { return std::make_tuple(false, best, best_i); }
+         }
+         return std::make_tuple(true, best, best_i);
+       }
+
+       enum class approx_method { approximate, naive, bussieck };
+
+       // approximate a sample of outputs and predict the cost of the three methods in units of pairs of the vectorized naive kernel.
+       // An output that is not settled makes the naive kernel compute its whole block, hence an isolated failure is charged the block size times its pairs.
+       // Failures of neighbouring probes indicate a run of failing outputs, which share their blocks and are charged their pairs only.
+       // The method of Bussieck et al visits pairs in sorted order as the scan does with zero tolerance, hence its cost is predicted from exactly settling the same outputs.
+       // Its fixed overhead is not predicted, it is only considered if with_bussieck is set, i.e. where min_conv uses it.
+       // Return the cheapest method and the average number of pairs of the sampled outputs.
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename VALUE_TYPE, typename TOLERANCE>
+       approx_method min_conv_approx_method(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_a,
+           INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_b,
+           const std::size_t result_size, TOLERANCE tolerance, const bool with_bussieck, double& average_pairs)
+       {
+         const std::size_t a_size = std::distance(a_begin, a_end);
+         const std::size_t b_size = std::distance(b_begin, b_end);
+         const double approx_rank_cost = 2 * approx_lanes<VALUE_TYPE>() * min_conv_approx_visit_cost;
+         const double heap_rank_cost = 2 * approx_lanes<VALUE_TYPE>() * min_conv_approx_heap_cost;
+         std::array<std::size_t, min_conv_approx_probes> failed_pairs;
+         double visit_cost = 0.0;
+         double bussieck_cost = 0.0;
+         double naive_cost = 0.0;
+         for(std::size_t p=0; p<min_conv_approx_probes; ++p) {
+           const std::size_t k = (2*p+1) * result_size / (2*min_conv_approx_probes);
+           const std::size_t nr_pairs = std::min(k+1, a_size) - (k+1 > b_size ? k+1 - b_size : 0);
+           std::size_t nr_visited = 0;
+           std::size_t nr_visited_exact = 0;
+           const bool approximated = std::get<0>(arg_min_sum_approx(a_begin, a_end, idx_a, b_begin, b_end, idx_b, k, tolerance, approx_rank_cost, nr_visited));
+           arg_min_sum_approx(a_begin, a_end, idx_a, b_begin, b_end, idx_b, k, additive_tolerance{0.0}, heap_rank_cost, nr_visited_exact);
+           visit_cost += approx_rank_cost * nr_visited;
+           failed_pairs[p] = approximated ? 0 : nr_pairs;
+           bussieck_cost += heap_rank_cost * nr_visited_exact;
+           naive_cost += nr_pairs;
+         }
+         double failed_cost = 0.0;
+         for(std::size_t p=0; p<min_conv_approx_probes; ++p) {
+           const bool run = (p > 0 && failed_pairs[p-1] > 0) || (p+1 < min_conv_approx_probes && failed_pairs[p+1] > 0);
+           failed_cost += double(failed_pairs[p]) * (run ? 1 : approx_block_size<VALUE_TYPE>());
+         }
+         average_pairs = naive_cost / min_conv_approx_probes;
+         const double approx_cost = visit_cost + std::min(failed_cost, naive_cost);
+         const double exact_cost = with_bussieck ? std::min(naive_cost, bussieck_cost) : naive_cost;
+         if(approx_cost < exact_cost) { return approx_method::approximate; }
+         return with_bussieck && bussieck_cost < naive_cost ? approx_method::bussieck : approx_method::naive;
+       }
+
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename TOLERANCE>
+       void min_conv_approx(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, TOLERANCE tolerance)
+       {
+         using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+         static_assert(std::is_floating_point<VALUE_TYPE>::value, "approximation is implemented for floating point values, integer costs are computed exactly by min_conv");
+         constexpr bool with_index = !std::is_same<OUTPUT_ITERATOR_INDEX, null_iterator>::value;
+
+         // structured input as in min_conv_dispatch. The sample chooses between the naive method and the others, hence only problems below min_conv_threshold skip it.
+         const std::size_t a_size = std::distance(a_begin, a_end);
+         const std::size_t b_size = std::distance(b_begin, b_end);
+         const std::size_t result_size = std::distance(result_begin, result_end);
+         assert(sums_fit(a_begin, a_end, b_begin, b_end));
+         const std::size_t naive_threshold = detail::naive_threshold<INPUT_ITERATOR_1, INPUT_ITERATOR_2, OUTPUT_ITERATOR_VAL>(a_size, b_size);
+         if(min_conv_detect_structure && result_size >= min_conv_threshold) {
+           const bool use_smawk = result_size >= std::min(naive_threshold, min_conv_smawk_threshold);
+           if(min_conv_structured(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, use_smawk)) { return; }
+         }
+         if(result_size < min_conv_threshold) {
+           min_conv_naive_or_arg_min(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+           return;
+         }
+
+         auto nr_pairs = [&](const std::size_t k) { return std::min(k+1, a_size) - (k+1 > b_size ? k+1 - b_size : 0); };
+         double naive_cost = 0.0;
+         for(std::size_t k=0; k<result_size; ++k) { naive_cost += nr_pairs(k); }
+         const double sort_cost = approx_lanes<VALUE_TYPE>() * min_conv_approx_sort_cost * (a_size * std::log2(double(a_size)) + b_size * std::log2(double(b_size)));
+         if(sort_cost > min_conv_approx_max_overhead * naive_cost) {
+           min_conv_naive_or_arg_min(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+           return;
+         }
+
+         const auto idx_a = detail::sort_indices(a_begin, a_end);
+         const auto idx_b = detail::sort_indices(b_begin, b_end);
+
+         // the method of Bussieck et al is considered where min_conv uses it
+         const bool with_bussieck = result_size >= naive_threshold;
+         double average_pairs;
+         const approx_method method = min_conv_approx_method(a_begin, a_end, idx_a, b_begin, b_end, idx_b, result_size, tolerance, with_bussieck, average_pairs);
+         // compute the outputs from k_begin on exactly, the method of Bussieck et al computes all of them
+         auto exact = [&](const std::size_t k_begin) {
+           if(method == approx_method::bussieck) {
+             min_conv_workspace<VALUE_TYPE> workspace;
+             min_conv_Bussieck_et_al(a_begin, a_end, idx_a, b_begin, b_end, idx_b, result_begin, result_end, result_index_a_begin, workspace);
+           } else {
+             min_conv_naive_range<with_index>(a_begin, a_end, b_begin, b_end, result_begin, k_begin, result_size, result_index_a_begin);
+           }
+         };
+         if(method != approx_method::approximate) {
+           exact(0);
+           return;
+         }
+
+         // blocks with an output that is not settled are computed by the naive kernel.
+         // Outputs near the ends have few pairs, are rarely settled and are cheap for the naive kernel, hence only failures on outputs with at least the average number of pairs are counted.
+         const double rank_cost = 2 * approx_lanes<VALUE_TYPE>() * min_conv_approx_visit_cost;
+         const std::size_t block_size = approx_block_size<VALUE_TYPE>();
+         std::size_t nr_failures = 0;
+         std::size_t nr_visited = 0;
+         for(std::size_t block_begin=0; block_begin<result_size; block_begin+=block_size) {
+           const std::size_t block_end = std::min(result_size, block_begin + block_size);
+           bool failed = false;
+           for(std::size_t k=block_begin; k<block_end; ++k) {
+             bool approximated;
+             VALUE_TYPE val;
+             std::size_t i;
+             std::tie(approximated, val, i) = arg_min_sum_approx(a_begin, a_end, idx_a, b_begin, b_end, idx_b, k, tolerance, rank_cost, nr_visited);
+             if(approximated) {
+               result_begin[k] = val;
+               result_index_a_begin[k] = i;
+               nr_failures = 0;
+             } else {
+               failed = true;
+               if(nr_pairs(k) >= average_pairs && ++nr_failures >= min_conv_approx_max_failures) {
+                 exact(block_begin);
+                 return;
+               }
+             }
+           }
+           if(failed) { min_conv_naive_range<with_index>(a_begin, a_end, b_begin, b_end, result_begin, block_begin, block_end, result_index_a_begin); }
+         }
+       }
+
+  } // end namespace detail
+
+      // approximate min convolution of non-negative input: every output is at least the exact value and at most (1+epsilon) times it.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_approx(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, const double epsilon)
+      {
+        assert(epsilon >= 0.0);
+        detail::min_conv_approx(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, detail::relative_tolerance{epsilon});
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+      void min_conv_approx(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, const double epsilon)
+      {
+        min_conv_approx(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator(), epsilon);
+      }
+
+      // approximate min convolution: every output is at least the exact value and at most the exact value plus delta.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_approx_additive(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, const double delta)
+      {
+        assert(delta >= 0.0);
+        detail::min_conv_approx(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, detail::additive_tolerance{delta});
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+      void min_conv_approx_additive(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, const double delta)
+      {
+        min_conv_approx_additive(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator(), delta);
+      }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_APPROX_HXX
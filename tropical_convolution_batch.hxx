@@ -0,0 +1,136 @@
+#ifndef TROPICAL_CONVOLUTION_BATCH_HXX
+#define TROPICAL_CONVOLUTION_BATCH_HXX
+
+#include "tropical_convolution.hxx"
+#include "tropical_convolution_thread_pool.hxx"
+#include <iterator>
+#include <numeric>
+#include <algorithm>
+#include <vector>
+#include <cassert>
+
+// run many independent min convolutions in parallel, e.g. all messages of one iteration of a message passing solver.
+// Problems are ordered by estimated cost and dealt out to the workers of a thread pool, cheap problems are grouped so that scheduling overhead stays small.
+// Every worker reuses one min_conv_workspace for all of its problems.
+
+namespace tropical_convolution {
+
+  // non-owning view of contiguous memory, e.g. for passing parts of a larger array to min_conv_batch.
+  template<typename VALUE_TYPE>
+  class span {
+    public:
+      span() : data_(nullptr), size_(0) {}
+      span(VALUE_TYPE* data, const std::size_t size) : data_(data), size_(size) {}
+      span(VALUE_TYPE* first, VALUE_TYPE* last) : data_(first), size_(last - first) {}
+
+      VALUE_TYPE* begin() const { return data_; }
+      VALUE_TYPE* end() const { return data_ + size_; }
+      VALUE_TYPE* data() const { return data_; }
+      std::size_t size() const { return size_; }
+      VALUE_TYPE& operator[](const std::size_t i) const { assert(i < size_); return data_[i]; }
+
+    private:
+      VALUE_TYPE* data_;
+      std::size_t size_;
+  };
+
+  // problems whose estimated cost is below this value are grouped into one task.
+  static const std::size_t min_conv_batch_grain = 1 << 16;
+
+  namespace detail {
+
+       template<typename RANGE_ITERATOR>
+       using range_value_type = typename std::iterator_traits<decltype(std::begin(*std::declval<RANGE_ITERATOR>()))>::value_type;
+
+       // conv(p, workspace) computes problem p. cost[p] is proportional to the expected runtime.
+       template<typename VALUE_TYPE, typename CONV>
+       void min_conv_batch(const std::vector<std::size_t>& cost, thread_pool& pool, CONV conv)
+       {
+         // sort by decreasing cost. Task t is queued at worker t % pool.size(), hence every worker starts with a similar amount of work and large problems are computed first.
+         std::vector<std::size_t> order(cost.size());
+         std::iota(order.begin(), order.end(), 0);
+         std::stable_sort(order.begin(), order.end(), [&](const std::size_t p, const std::size_t q) { return cost[p] > cost[q]; });
+
+         std::vector<std::size_t> task_begin;
+         std::size_t task_cost = min_conv_batch_grain;
+         for(std::size_t k=0; k<order.size(); ++k) {
+           if(task_cost >= min_conv_batch_grain) {
+             task_begin.push_back(k);
+             task_cost = 0;
+           }
+           task_cost += cost[order[k]];
+         }
+         task_begin.push_back(order.size());
+
+         std::vector<min_conv_workspace<VALUE_TYPE>> workspaces(pool.size());
+         pool.run(task_begin.size()-1, [&](const std::size_t t, const std::size_t worker) {
+             for(std::size_t k=task_begin[t]; k<task_begin[t+1]; ++k) {
+               conv(order[k], workspaces[worker]);
+             }
+         });
+       }
+
+       template<typename INPUT_RANGE_ITERATOR_1, typename INPUT_RANGE_ITERATOR_2, typename OUTPUT_RANGE_ITERATOR>
+       std::vector<std::size_t> min_conv_batch_cost(INPUT_RANGE_ITERATOR_1 a_begin, INPUT_RANGE_ITERATOR_1 a_end, INPUT_RANGE_ITERATOR_2 b_begin, OUTPUT_RANGE_ITERATOR result_begin)
+       {
+         std::vector<std::size_t> cost(std::distance(a_begin, a_end));
+         for(std::size_t p=0; p<cost.size(); ++p) {
+           const std::size_t a_size = std::distance(std::begin(a_begin[p]), std::end(a_begin[p]));
+           const std::size_t b_size = std::distance(std::begin(b_begin[p]), std::end(b_begin[p]));
+           const std::size_t result_size = std::distance(std::begin(result_begin[p]), std::end(result_begin[p]));
+           cost[p] = result_size * std::min(a_size, b_size) + 64; // naive runtime plus a constant overhead per call
+         }
+         return cost;
+       }
+
+  } // end namespace detail
+
+      // compute min_conv(a[p], b[p]) into result[p] for every p in [0, a_end - a_begin). Elements of the three sequences are ranges, e.g. std::vector or span.
+      // The length of result[p] determines how many values are computed, as for min_conv.
+      template<typename INPUT_RANGE_ITERATOR_1, typename INPUT_RANGE_ITERATOR_2, typename OUTPUT_RANGE_ITERATOR>
+      void min_conv_batch(INPUT_RANGE_ITERATOR_1 a_begin, INPUT_RANGE_ITERATOR_1 a_end, INPUT_RANGE_ITERATOR_2 b_begin, OUTPUT_RANGE_ITERATOR result_begin, thread_pool& pool)
+      {
+        using VALUE_TYPE = detail::range_value_type<INPUT_RANGE_ITERATOR_1>;
+        const auto cost = detail::min_conv_batch_cost(a_begin, a_end, b_begin, result_begin);
+        detail::min_conv_batch<VALUE_TYPE>(cost, pool, [&](const std::size_t p, min_conv_workspace<VALUE_TYPE>& workspace) {
+            auto&& a = a_begin[p];
+            auto&& b = b_begin[p];
+            auto&& result = result_begin[p];
+            min_conv(std::begin(a), std::end(a), std::begin(b), std::end(b), std::begin(result), std::end(result), workspace);
+        });
+      }
+
+      template<typename INPUT_RANGE_ITERATOR_1, typename INPUT_RANGE_ITERATOR_2, typename OUTPUT_RANGE_ITERATOR>
+      void min_conv_batch(INPUT_RANGE_ITERATOR_1 a_begin, INPUT_RANGE_ITERATOR_1 a_end, INPUT_RANGE_ITERATOR_2 b_begin, OUTPUT_RANGE_ITERATOR result_begin)
+      {
+        min_conv_batch(a_begin, a_end, b_begin, result_begin, default_thread_pool());
+      }
+
+      // additionally return for every problem the indices coming from the first vector for the optimum convolution.
+      template<typename INPUT_RANGE_ITERATOR_1, typename INPUT_RANGE_ITERATOR_2, typename OUTPUT_RANGE_ITERATOR_VAL, typename OUTPUT_RANGE_ITERATOR_INDEX>
+      void min_conv_batch(
+          INPUT_RANGE_ITERATOR_1 a_begin, INPUT_RANGE_ITERATOR_1 a_end, INPUT_RANGE_ITERATOR_2 b_begin,
+          OUTPUT_RANGE_ITERATOR_VAL result_begin, OUTPUT_RANGE_ITERATOR_INDEX result_index_a_begin, thread_pool& pool)
+      {
+        using VALUE_TYPE = detail::range_value_type<INPUT_RANGE_ITERATOR_1>;
+        const auto cost = detail::min_conv_batch_cost(a_begin, a_end, b_begin, result_begin);
+        detail::min_conv_batch<VALUE_TYPE>(cost, pool, [&](const std::size_t p, min_conv_workspace<VALUE_TYPE>& workspace) {
+            auto&& a = a_begin[p];
+            auto&& b = b_begin[p];
+            auto&& result = result_begin[p];
+            auto&& result_index = result_index_a_begin[p];
+            min_conv(std::begin(a), std::end(a), std::begin(b), std::end(b), std::begin(result), std::end(result), std::begin(result_index), workspace);
+        });
+      }
+
+      template<typename INPUT_RANGE_ITERATOR_1, typename INPUT_RANGE_ITERATOR_2, typename OUTPUT_RANGE_ITERATOR_VAL, typename OUTPUT_RANGE_ITERATOR_INDEX>
+      void min_conv_batch(
+          INPUT_RANGE_ITERATOR_1 a_begin, INPUT_RANGE_ITERATOR_1 a_end, INPUT_RANGE_ITERATOR_2 b_begin,
+          OUTPUT_RANGE_ITERATOR_VAL result_begin, OUTPUT_RANGE_ITERATOR_INDEX result_index_a_begin)
+      {
+        min_conv_batch(a_begin, a_end, b_begin, result_begin, result_index_a_begin, default_thread_pool());
+      }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_BATCH_HXX
@@ -1,4 +1,5 @@
 #include "tropical_convolution.hxx"
+#include "tropical_convolution_batch.hxx"
 #include <iostream>
 #include <vector>
 #include <algorithm>
@@ -24,10 +25,16 @@ void benchmark(std::vector<std::vector<double>>& a, std::vector<std::vector<doub
   }
   auto end_Bussieck_et_al = std::chrono::high_resolution_clock::now();
 
+  std::vector<std::vector<double>> batch_result(runs, std::vector<double>(2*size-1));
+  auto begin_batch = std::chrono::high_resolution_clock::now();
+  tropical_convolution::min_conv_batch(a.begin(), a.end(), b.begin(), batch_result.begin());
+  auto end_batch = std::chrono::high_resolution_clock::now();
+
   std::cout << "Input size = " << size 
     << "; # runs = " << runs
     << "; naive: " << std::chrono::duration_cast<std::chrono::milliseconds>(end_naive-begin_naive).count() 
-    << " ms; Bussieck et al: " << std::chrono::duration_cast<std::chrono::milliseconds>(end_Bussieck_et_al-begin_Bussieck_et_al).count() << " ms" << std::endl;
+    << " ms; Bussieck et al: " << std::chrono::duration_cast<std::chrono::milliseconds>(end_Bussieck_et_al-begin_Bussieck_et_al).count() 
+    << " ms; min_conv_batch (" << tropical_convolution::default_thread_pool().size() << " threads): " << std::chrono::duration_cast<std::chrono::milliseconds>(end_batch-begin_batch).count() << " ms" << std::endl;
 }
 
 // compare runtimes of tropical convolution implementations
@@ -0,0 +1,203 @@
+#include "tropical_convolution.hxx"
+#include "tropical_convolution_approx.hxx"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+// benchmark the naive method, the method of Bussieck et al and min_conv on several input distributions, value types and operand shapes.
+// Output is one CSV line (default) or one JSON object (--json) per measurement, with the counters of Bussieck et al, to find inputs on which it degrades.
+// For floating point values min_conv_approx is timed as well.
+// usage: tropical_convolution_benchmark_suite [--json] [--max-size n]
+
+enum class distribution { uniform, sorted, convex, near_constant, heavy_tailed, infinities };
+static const char* const distribution_names[] = {"uniform", "sorted", "convex", "near_constant", "heavy_tailed", "infinities"};
+
+// shape of the problem: operand sizes and length of the result.
+struct shape {
+  const char* name;
+  std::size_t a_size;
+  std::size_t b_size;
+  std::size_t result_size;
+};
+
+template<typename VALUE_TYPE>
+std::vector<VALUE_TYPE> generate(std::mt19937& gen, const distribution dist, const std::size_t size)
+{
+  const bool integral = std::is_integral<VALUE_TYPE>::value;
+  std::uniform_real_distribution<double> uniform(0.0, 1.0);
+  std::vector<double> x(size);
+  switch(dist) {
+    case distribution::uniform:
+      for(auto& v : x) { v = 1000.0 * uniform(gen); }
+      break;
+    case distribution::sorted:
+      for(auto& v : x) { v = 1000.0 * uniform(gen); }
+      std::sort(x.begin(), x.end());
+      break;
+    case distribution::convex: {
+      std::vector<double> slopes(size);
+      for(auto& s : slopes) { s = 2000.0 * uniform(gen) - 1000.0; }
+      std::sort(slopes.begin(), slopes.end());
+      x[0] = 0.0;
+      for(std::size_t i=1; i<size; ++i) { x[i] = x[i-1] + (integral ? std::round(slopes[i-1]) : slopes[i-1]); }
+      break;
+    }
+    case distribution::near_constant: // spread over about a hundred units in the last place, representable in VALUE_TYPE
+      for(auto& v : x) { v = integral ? 1000.0 + (uniform(gen) < 0.5) : 1000.0 * (1.0 + 64.0 * std::numeric_limits<VALUE_TYPE>::epsilon() * uniform(gen)); }
+      break;
+    case distribution::heavy_tailed: // Pareto with shape 1
+      for(auto& v : x) { v = std::min(1e9, 1.0 / (1.0 - uniform(gen))); }
+      break;
+    case distribution::infinities: // a fifth of the entries are infinite
+      for(auto& v : x) { v = uniform(gen) < 0.2 ? std::numeric_limits<double>::infinity() : 1000.0 * uniform(gen); }
+      break;
+  }
+  return std::vector<VALUE_TYPE>(x.begin(), x.end());
+}
+
+// nanoseconds per call, calls are repeated for at least 20 ms.
+template<typename F>
+double time_ns(F f)
+{
+  using clock = std::chrono::steady_clock;
+  f(); // warm up
+  std::size_t nr_calls = 0;
+  const auto begin = clock::now();
+  auto end = begin;
+  do {
+    f();
+    ++nr_calls;
+    end = clock::now();
+  } while(end - begin < std::chrono::milliseconds(20));
+  return std::chrono::duration<double, std::nano>(end - begin).count() / nr_calls;
+}
+
+static const double approx_epsilon = 0.01;
+
+template<typename VALUE_TYPE>
+double time_approx(const std::vector<VALUE_TYPE>& a, const std::vector<VALUE_TYPE>& b, std::vector<VALUE_TYPE>& result, std::true_type)
+{
+  return time_ns([&]() { tropical_convolution::min_conv_approx(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), approx_epsilon); });
+}
+
+// integer costs are not approximated
+template<typename VALUE_TYPE>
+double time_approx(const std::vector<VALUE_TYPE>&, const std::vector<VALUE_TYPE>&, std::vector<VALUE_TYPE>&, std::false_type)
+{
+  return -1.0;
+}
+
+struct measurement {
+  std::string value_type;
+  std::string distribution;
+  shape s;
+  std::string algorithm;
+  double ns_per_call;
+  tropical_convolution::min_conv_statistics statistics;
+  bool has_statistics = false; // only the method of Bussieck et al collects them
+};
+
+void print(const measurement& m, const bool json)
+{
+  const double ns_per_output = m.ns_per_call / m.s.result_size;
+  const double outputs_per_second = 1e9 / ns_per_output;
+  const auto& st = m.statistics;
+  // counters of algorithms that do not collect them are null (JSON) or empty (CSV), not zero
+  auto counter = [&](const std::size_t c) { return m.has_statistics ? std::to_string(c) : json ? std::string("null") : std::string(); };
+  const std::string fallback = m.has_statistics ? (st.fallbacks > 0 ? "true" : "false") : "null";
+  if(json) {
+    std::cout << "{\"value_type\": \"" << m.value_type << "\", \"distribution\": \"" << m.distribution << "\", \"shape\": \"" << m.s.name << "\""
+      << ", \"a_size\": " << m.s.a_size << ", \"b_size\": " << m.s.b_size << ", \"result_size\": " << m.s.result_size
+      << ", \"algorithm\": \"" << m.algorithm << "\", \"ns_per_output\": " << ns_per_output << ", \"outputs_per_second\": " << outputs_per_second
+      << ", \"pushes\": " << counter(st.pushes) << ", \"pops\": " << counter(st.pops) << ", \"max_queue_size\": " << counter(st.max_queue_size)
+      << ", \"scan_i\": " << counter(st.scan_i) << ", \"scan_j\": " << counter(st.scan_j)
+      << ", \"fallback\": " << fallback << ", \"open_at_fallback\": " << counter(st.open_at_fallback) << ", \"pops_at_fallback\": " << counter(st.pops_at_fallback)
+      << "}";
+  } else {
+    std::cout << m.value_type << "," << m.distribution << "," << m.s.name << "," << m.s.a_size << "," << m.s.b_size << "," << m.s.result_size << ","
+      << m.algorithm << "," << ns_per_output << "," << outputs_per_second << ","
+      << counter(st.pushes) << "," << counter(st.pops) << "," << counter(st.max_queue_size) << "," << counter(st.scan_i) << "," << counter(st.scan_j) << ","
+      << counter(st.fallbacks) << "," << counter(st.open_at_fallback) << "," << counter(st.pops_at_fallback) << "\n";
+  }
+}
+
+template<typename VALUE_TYPE>
+void benchmark(const std::string& value_type, const std::vector<distribution>& distributions, const std::vector<shape>& shapes, const bool json, bool& first)
+{
+  std::mt19937 gen(1);
+  tropical_convolution::min_conv_workspace<VALUE_TYPE> workspace;
+  for(const auto dist : distributions) {
+    for(const auto& s : shapes) {
+      const auto a = generate<VALUE_TYPE>(gen, dist, s.a_size);
+      const auto b = generate<VALUE_TYPE>(gen, dist, s.b_size);
+      std::vector<VALUE_TYPE> result(s.result_size);
+
+      std::vector<measurement> ms;
+      ms.push_back({value_type, distribution_names[int(dist)], s, "naive",
+          time_ns([&]() { tropical_convolution::min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end()); }), {}});
+      measurement m{value_type, distribution_names[int(dist)], s, "Bussieck_et_al",
+          time_ns([&]() { tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), workspace); }), {}};
+      tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), workspace, m.statistics);
+      m.has_statistics = true;
+      ms.push_back(m);
+      ms.push_back({value_type, distribution_names[int(dist)], s, "min_conv",
+          time_ns([&]() { tropical_convolution::min_conv(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), workspace); }), {}});
+      const double approx_ns = time_approx(a, b, result, std::is_floating_point<VALUE_TYPE>());
+      if(approx_ns >= 0.0) { ms.push_back({value_type, distribution_names[int(dist)], s, "approx", approx_ns, {}}); }
+
+      for(const auto& m : ms) {
+        if(json) { std::cout << (first ? "[\n  " : ",\n  "); }
+        first = false;
+        print(m, json);
+      }
+    }
+  }
+}
+
+int main(int argc, char** argv)
+{
+  bool json = false;
+  std::size_t max_size = 8192;
+  for(int i=1; i<argc; ++i) {
+    if(std::strcmp(argv[i], "--json") == 0) {
+      json = true;
+    } else if(std::strcmp(argv[i], "--max-size") == 0 && i+1 < argc) {
+      max_size = std::strtoul(argv[++i], nullptr, 10);
+    } else {
+      std::cerr << "usage: " << argv[0] << " [--json] [--max-size n]" << std::endl;
+      return 1;
+    }
+  }
+
+  std::vector<shape> shapes;
+  for(std::size_t n=256; n<=max_size; n*=4) {
+    shapes.push_back({"equal", n, n, 2*n-1});
+    shapes.push_back({"unequal", n, std::max(std::size_t(2), n/16), n + std::max(std::size_t(2), n/16) - 1});
+    shapes.push_back({"truncated", n, n, n});
+  }
+
+  const std::vector<distribution> real_distributions = {
+    distribution::uniform, distribution::sorted, distribution::convex, distribution::near_constant, distribution::heavy_tailed, distribution::infinities};
+  // sums of integer infinities overflow
+  const std::vector<distribution> integer_distributions = {
+    distribution::uniform, distribution::sorted, distribution::convex, distribution::near_constant, distribution::heavy_tailed};
+
+  bool first = true;
+  if(!json) {
+    std::cout << "value_type,distribution,shape,a_size,b_size,result_size,algorithm,ns_per_output,outputs_per_second,"
+      << "pushes,pops,max_queue_size,scan_i,scan_j,fallbacks,open_at_fallback,pops_at_fallback\n";
+  }
+  benchmark<float>("float", real_distributions, shapes, json, first);
+  benchmark<double>("double", real_distributions, shapes, json, first);
+  benchmark<std::int32_t>("int32", integer_distributions, shapes, json, first);
+  if(json) { std::cout << (first ? "[]\n" : "\n]\n"); }
+}
@@ -2,18 +2,21 @@
 #define TROPICAL_CONVOLUTION_BUSSIECK_HXX
 
 #include "min_sum.hxx"
+#include "tropical_convolution_radix_queue.hxx"
+#include "tropical_convolution_tuning.hxx"
 #include <limits>
 #include <cmath>
 #include <functional>
-#include <queue>
 #include <algorithm>
 #include <vector>
+#include <type_traits>
 #include <cassert>
 
 // implement the tropical convolution algorithm described in
 // M. Bussieck, H. Hassler, G. J. Woeginger, and U. T. Zimmermann:
 // Fast algorithms for the maximum convolution problem.
 // Oper. Res. Let.  , 15:1–5, 1994
+// Integer sums are not guarded against overflow, integer input must satisfy detail::sums_fit.
 
 namespace tropical_convolution {
 
@@ -25,17 +28,30 @@ namespace tropical_convolution {
          std::size_t idx;
        };
 
+       template<typename VALUE_TYPE>
+       struct indices_value_pair {
+         std::size_t i;
+         std::size_t j;
+         VALUE_TYPE val;
+       };
+
        template<typename ITERATOR>
-       std::vector<index_value_pair<typename std::iterator_traits<ITERATOR>::value_type>> sort_indices(ITERATOR begin, ITERATOR end)
+       void sort_indices(ITERATOR begin, ITERATOR end, std::vector<index_value_pair<typename std::iterator_traits<ITERATOR>::value_type>>& idx)
        {
-         using VALUE_TYPE = typename std::iterator_traits<ITERATOR>::value_type;
-         std::vector<index_value_pair<VALUE_TYPE>> idx(std::distance(begin,end));
+         idx.resize(std::distance(begin,end));
          for(auto i=0; i<idx.size(); ++i) {
            idx[i].idx = i;
            idx[i].val = begin[i];
          }
          auto compare = [&](const auto& x, const auto& y){ return x.val < y.val; };
          std::sort(idx.begin(), idx.end(), compare);
+       }
+
+       template<typename ITERATOR>
+       std::vector<index_value_pair<typename std::iterator_traits<ITERATOR>::value_type>> sort_indices(ITERATOR begin, ITERATOR end)
+       {
+         std::vector<index_value_pair<typename std::iterator_traits<ITERATOR>::value_type>> idx;
+         sort_indices(begin, end, idx);
          return idx; 
        }
 
@@ -50,22 +66,19 @@ namespace tropical_convolution {
          return false;
        }
 
-       // fill missing values explicit min sum computation
+       // fill values in [k_begin, k_end) that are not marked in assigned by explicit min sum computation. Disjoint ranges can be filled independently.
        template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
        void min_sum_missing(
            INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, 
-           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+           OUTPUT_ITERATOR_VAL result_begin, const std::size_t k_begin, const std::size_t k_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+           const std::vector<unsigned char>& assigned)
        {
          using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
          static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<INPUT_ITERATOR_2>::value_type>::value, "input iterators must have same value type");
          static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<OUTPUT_ITERATOR_VAL>::value_type>::value, "input and output iterators must have same value type");
 
-         const auto a_size = std::distance(a_begin, a_end);
-         const auto b_size = std::distance(b_begin, b_end);
-         const auto result_size = std::distance(result_begin, result_end);
-
-         for(auto i=0; i<result_size; ++i) {
-           if(result_begin[i] == std::numeric_limits<VALUE_TYPE>::infinity()) { // not assigned yet
+         for(auto i=k_begin; i<k_end; ++i) {
+           if(!assigned[i]) {
              std::size_t a_idx, b_idx;
              std::tie(result_begin[i], a_idx, b_idx) = arg_min_sum(a_begin, a_end, b_begin, b_end, i);
              result_index_a_begin[i] = a_idx;
@@ -73,50 +86,148 @@ namespace tropical_convolution {
          }
        }
 
+       // binary heap on top of a vector, returning the element with the smallest value first.
+       template<typename ELEMENT>
+       class binary_heap_queue {
+         public:
+           void push(const ELEMENT& e)
+           {
+             heap_.push_back(e);
+             std::push_heap(heap_.begin(), heap_.end(), compare);
+           }
+           const ELEMENT& top() const { return heap_.front(); }
+           void pop()
+           {
+             std::pop_heap(heap_.begin(), heap_.end(), compare);
+             heap_.pop_back();
+           }
+           std::size_t size() const { return heap_.size(); }
+           bool empty() const { return heap_.empty(); }
+           void clear() { heap_.clear(); }
+
+         private:
+           static bool compare(const ELEMENT& x, const ELEMENT& y)
+           {
+             return x.val > y.val; // std::push_heap keeps the largest element on top, hence we have to invert sorting.
+           }
+           std::vector<ELEMENT> heap_;
+       };
+
+       // integer sums are enumerated with a radix queue, other types with a binary heap.
+       template<typename VALUE_TYPE>
+       using bussieck_queue = typename std::conditional<std::is_integral<VALUE_TYPE>::value,
+             radix_queue<indices_value_pair<VALUE_TYPE>>, binary_heap_queue<indices_value_pair<VALUE_TYPE>>>::type;
+
+       // statistics hook doing nothing, the calls are optimized away.
+       struct null_statistics {
+         void on_call(std::size_t) {}
+         void on_push(std::size_t) {}
+         void on_pop() {}
+         void on_scan_i(std::size_t) {}
+         void on_scan_j(std::size_t) {}
+         void on_fallback(std::size_t, std::size_t) {}
+       };
+
      } // end namespace detail
 
-      // return convolution values and additionally the index coming from the first vector for the optimum convolution. 
-      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      // counters of the method of Bussieck et al, summed over all calls given the same object. Used for finding inputs on which it is slow.
+      struct min_conv_statistics {
+        std::size_t calls = 0;
+        std::size_t outputs = 0;
+        std::size_t pushes = 0; // queue operations
+        std::size_t pops = 0;
+        std::size_t max_queue_size = 0;
+        std::size_t scan_i = 0; // elements visited by add_cover_i and add_cover_j
+        std::size_t scan_j = 0;
+        std::size_t fallbacks = 0; // calls that computed remaining values with min_sum_missing
+        std::size_t open_at_fallback = 0; // number of values computed by min_sum_missing
+        std::size_t pops_at_fallback = 0; // pops before min_sum_missing was called
+
+        void on_call(const std::size_t result_size) { ++calls; outputs += result_size; }
+        void on_push(const std::size_t queue_size) { ++pushes; max_queue_size = std::max(max_queue_size, queue_size); }
+        void on_pop() { ++pops; }
+        void on_scan_i(const std::size_t length) { scan_i += length; }
+        void on_scan_j(const std::size_t length) { scan_j += length; }
+        void on_fallback(const std::size_t open, const std::size_t pops_so_far) { ++fallbacks; open_at_fallback += open; pops_at_fallback += pops_so_far; }
+      };
+
+      // memory used by min_conv_Bussieck_et_al: sort buffers, cover and assignment arrays and the priority queue.
+      // Reusing it across calls avoids allocating them anew each time, once it has grown to the largest input no allocation takes place.
+      template<typename VALUE_TYPE>
+      struct min_conv_workspace {
+        std::vector<detail::index_value_pair<VALUE_TYPE>> idx_a;
+        std::vector<detail::index_value_pair<VALUE_TYPE>> idx_b;
+        std::vector<unsigned char> cover_a;
+        std::vector<unsigned char> cover_b;
+        std::vector<unsigned char> assigned; // whether an output has been computed, kept apart from the values since any value can occur in the input
+        detail::bussieck_queue<VALUE_TYPE> queue;
+      };
+
+      // copy of an operand together with its sorted indices, for convolving a fixed operand (e.g. a pairwise potential) with many others without sorting it each time.
+      template<typename VALUE_TYPE>
+      class prepared_operand {
+        public:
+          template<typename ITERATOR>
+          prepared_operand(ITERATOR begin, ITERATOR end)
+            : values_(begin, end)
+          {
+            detail::sort_indices(values_.begin(), values_.end(), sorted_);
+          }
+
+          typename std::vector<VALUE_TYPE>::const_iterator begin() const { return values_.begin(); }
+          typename std::vector<VALUE_TYPE>::const_iterator end() const { return values_.end(); }
+          std::size_t size() const { return values_.size(); }
+          const std::vector<detail::index_value_pair<VALUE_TYPE>>& sorted_indices() const { return sorted_; }
+
+        private:
+          std::vector<VALUE_TYPE> values_;
+          std::vector<detail::index_value_pair<VALUE_TYPE>> sorted_;
+      };
+
+  namespace detail {
+
+      // idx_a and idx_b hold the sorted indices of a and b respectively.
+      // fill_missing() is called to compute the values not assigned by the heap phase, usually by min_sum_missing.
+      // statistics is min_conv_statistics or null_statistics.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename VALUE_TYPE, typename STATISTICS, typename FILL_MISSING>
       void min_conv_Bussieck_et_al(
-          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, 
-          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_a,
+          INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_b,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<VALUE_TYPE>& workspace, STATISTICS& statistics, FILL_MISSING fill_missing)
       {
-        using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+        static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<INPUT_ITERATOR_1>::value_type>::value, "input iterators and sorted indices must have same value type");
         static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<INPUT_ITERATOR_2>::value_type>::value, "input iterators must have same value type");
         static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<OUTPUT_ITERATOR_VAL>::value_type>::value, "input and output iterators must have same value type");
-        //VALUE_TYPE val = std::numeric_limits<VALUE_TYPE>::infinity();
 
        const auto a_size = std::distance(a_begin, a_end);
        const auto b_size = std::distance(b_begin, b_end);
        const auto result_size = std::distance(result_begin, result_end);
        assert(result_size <= a_size + b_size - 1);
+       assert(idx_a.size() == a_size && idx_b.size() == b_size);
+       assert(detail::sums_fit(a_begin, a_end, b_begin, b_end));
 
-       // store sorted indices of vector a and b respectively
-       auto idx_a = detail::sort_indices(a_begin, a_end);
-       auto idx_b = detail::sort_indices(b_begin, b_end);
-
-       std::fill(result_begin, result_end, std::numeric_limits<VALUE_TYPE>::infinity()); // the output. Note: infinity is not really the best marker, since the input can have infinities as well! (but then the algorithm can terminate early once it has reached such a value.
+       std::fill(result_begin, result_end, detail::infinity<VALUE_TYPE>()); // the output
+       auto& assigned = workspace.assigned;
+       assigned.assign(result_size,0);
 
        std::size_t open = result_size;
+       const double fallback_ratio = detail::fallback_ratio<INPUT_ITERATOR_1, INPUT_ITERATOR_2, OUTPUT_ITERATOR_VAL>(a_size, b_size);
 
-       struct indices_value_pair {
-         std::size_t i;
-         std::size_t j;
-         VALUE_TYPE val;
-       };
-       auto compare = [](const indices_value_pair& x, const indices_value_pair& y) {
-         return x.val > y.val; // std::priority_queue keeps the largest element on top, hence we have to invert sorting.
-       };
-       std::priority_queue<indices_value_pair,std::vector<indices_value_pair>,decltype(compare) > queue(compare);
-       std::vector<unsigned char> cover_a(a_size,0);
-       std::vector<unsigned char> cover_b(b_size,0);
+       auto& queue = workspace.queue;
+       queue.clear();
+       auto& cover_a = workspace.cover_a;
+       auto& cover_b = workspace.cover_b;
+       cover_a.assign(a_size,0);
+       cover_b.assign(b_size,0);
 
        auto add_cover = [&](const std::size_t i, const std::size_t j) {
          assert(cover_a[i] <= 1 && cover_b[j] <= 1);
          if( cover_a[i] == 0 && cover_b[j] == 0) {
            cover_a[i] = 1;
            cover_b[j] = 1;
-           queue.push({i,j, idx_a[i].val + idx_b[j].val});
+           queue.push({i,j, VALUE_TYPE(idx_a[i].val + idx_b[j].val)});
+           statistics.on_push(queue.size());
          } 
        };
 
@@ -131,12 +242,14 @@ namespace tropical_convolution {
          if(cover_a[i+1] == 0 && cover_b[j] == 0) {
            for(std::size_t inc=i+1; inc<a_size; ++inc) {
              const std::size_t underlying_sum = idx_a[inc].idx + idx_b[j].idx;
-             if(underlying_sum < result_size && result_begin[underlying_sum] == std::numeric_limits<VALUE_TYPE>::infinity()) {
+             if(underlying_sum < result_size && !assigned[underlying_sum]) {
+               statistics.on_scan_i(inc - i);
                add_cover(inc,j);
                return;
              }
-             if(cover_a[inc] > 0) { return; }
+             if(cover_a[inc] > 0) { statistics.on_scan_i(inc - i); return; }
            }
+           statistics.on_scan_i(a_size - 1 - i);
          }
        };
 
@@ -144,23 +257,27 @@ namespace tropical_convolution {
          if(cover_a[i] == 0 && cover_b[j+1] == 0) {
            for(std::size_t inc=j+1; inc<b_size; ++inc) {
              const std::size_t underlying_sum = idx_a[i].idx + idx_b[inc].idx;
-             if(underlying_sum < result_size && result_begin[underlying_sum] == std::numeric_limits<VALUE_TYPE>::infinity()) { 
+             if(underlying_sum < result_size && !assigned[underlying_sum]) { 
+               statistics.on_scan_j(inc - j);
                add_cover(i,inc);
                return;
              }
-             if(cover_b[inc] > 0) { return; }
+             if(cover_b[inc] > 0) { statistics.on_scan_j(inc - j); return; }
            }
+           statistics.on_scan_j(b_size - 1 - j);
          }
        };
 
+       statistics.on_call(result_size);
+       std::size_t nr_pops = 0;
        add_cover(0,0); 
 
        while(open > 0) {
-         assert(!queue.empty());
-
          // check whether number of queue elements is larger than number of unassigned elements. If so, explicitly compute missing values
-         if(queue.size() > 0.08*open) { // 0.08 seems to be a good value based on preliminary experiments
-           detail::min_sum_missing(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+         // For a truncated result the queue can also run empty before all values are assigned, since pairs beyond the result are not pushed.
+         if(queue.empty() || queue.size() > fallback_ratio*open) {
+           statistics.on_fallback(open, nr_pops);
+           fill_missing();
            break;
          }
 
@@ -170,8 +287,9 @@ namespace tropical_convolution {
          assert(j < b_size);
          const auto val = queue.top().val;
          queue.pop();
+         ++nr_pops;
+         statistics.on_pop();
          remove_cover(i,j);
-         if(i+j >= result_size) { continue; }
          const auto underlying_i = idx_a[i].idx;
          assert(underlying_i < a_size);
          const auto underlying_j = idx_b[j].idx;
@@ -179,8 +297,9 @@ namespace tropical_convolution {
          const auto underlying_sum = underlying_i + underlying_j;
 
          // new minimum found
-         if(underlying_sum < result_size && result_begin[underlying_sum] == std::numeric_limits<VALUE_TYPE>::infinity()) {
+         if(underlying_sum < result_size && !assigned[underlying_sum]) {
            open--;
+           assigned[underlying_sum] = 1;
            result_begin[underlying_sum] = val;
            result_index_a_begin[underlying_sum] = underlying_i;
          }
@@ -205,21 +324,117 @@ namespace tropical_convolution {
        }
      }
 
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename VALUE_TYPE, typename STATISTICS>
+      void min_conv_Bussieck_et_al(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_a,
+          INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_b,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<VALUE_TYPE>& workspace, STATISTICS& statistics)
+      {
+        min_conv_Bussieck_et_al(a_begin, a_end, idx_a, b_begin, b_end, idx_b, result_begin, result_end, result_index_a_begin, workspace, statistics, [&]() {
+            min_sum_missing(a_begin, a_end, b_begin, b_end, result_begin, 0, std::distance(result_begin, result_end), result_index_a_begin, workspace.assigned);
+        });
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename VALUE_TYPE>
+      void min_conv_Bussieck_et_al(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_a,
+          INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, const std::vector<index_value_pair<VALUE_TYPE>>& idx_b,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<VALUE_TYPE>& workspace)
+      {
+        null_statistics statistics;
+        min_conv_Bussieck_et_al(a_begin, a_end, idx_a, b_begin, b_end, idx_b, result_begin, result_end, result_index_a_begin, workspace, statistics);
+      }
+
+  } // end namespace detail
+
+      // return convolution values and additionally the index coming from the first vector for the optimum convolution. 
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_Bussieck_et_al(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, 
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type>& workspace)
+      {
+        // store sorted indices of vector a and b respectively
+        detail::sort_indices(a_begin, a_end, workspace.idx_a);
+        detail::sort_indices(b_begin, b_end, workspace.idx_b);
+        detail::min_conv_Bussieck_et_al(a_begin, a_end, workspace.idx_a, b_begin, b_end, workspace.idx_b, result_begin, result_end, result_index_a_begin, workspace);
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_Bussieck_et_al(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, 
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+      {
+        min_conv_workspace<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type> workspace;
+        min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, workspace);
+      }
+
+      // additionally count the operations of the algorithm in statistics.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_Bussieck_et_al(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, 
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type>& workspace, min_conv_statistics& statistics)
+      {
+        detail::sort_indices(a_begin, a_end, workspace.idx_a);
+        detail::sort_indices(b_begin, b_end, workspace.idx_b);
+        detail::min_conv_Bussieck_et_al(a_begin, a_end, workspace.idx_a, b_begin, b_end, workspace.idx_b, result_begin, result_end, result_index_a_begin, workspace, statistics);
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR, typename VALUE_TYPE>
+      void min_conv_Bussieck_et_al(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end,
+          min_conv_workspace<VALUE_TYPE>& workspace, min_conv_statistics& statistics)
+      {
+        min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator(), workspace, statistics);
+      }
+
+      // b is prepared, only a needs to be sorted.
+      template<typename INPUT_ITERATOR_1, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename VALUE_TYPE>
+      void min_conv_Bussieck_et_al(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const prepared_operand<VALUE_TYPE>& b,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<VALUE_TYPE>& workspace)
+      {
+        detail::sort_indices(a_begin, a_end, workspace.idx_a);
+        detail::min_conv_Bussieck_et_al(a_begin, a_end, workspace.idx_a, b.begin(), b.end(), b.sorted_indices(), result_begin, result_end, result_index_a_begin, workspace);
+      }
+
+      // both operands prepared, no sorting takes place.
+      template<typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename VALUE_TYPE>
+      void min_conv_Bussieck_et_al(
+          const prepared_operand<VALUE_TYPE>& a, const prepared_operand<VALUE_TYPE>& b,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<VALUE_TYPE>& workspace)
+      {
+        detail::min_conv_Bussieck_et_al(a.begin(), a.end(), a.sorted_indices(), b.begin(), b.end(), b.sorted_indices(), result_begin, result_end, result_index_a_begin, workspace);
+      }
+
       // only return values of min convolution.
+     template<typename INPUT_ITERATOR_1, typename OUTPUT_ITERATOR, typename VALUE_TYPE>
+     void min_conv_Bussieck_et_al(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, const prepared_operand<VALUE_TYPE>& b, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_workspace<VALUE_TYPE>& workspace)
+     {
+       min_conv_Bussieck_et_al(a_begin, a_end, b, result_begin, result_end, detail::null_iterator(), workspace);
+     } 
+
+     template<typename OUTPUT_ITERATOR, typename VALUE_TYPE>
+     void min_conv_Bussieck_et_al(const prepared_operand<VALUE_TYPE>& a, const prepared_operand<VALUE_TYPE>& b, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_workspace<VALUE_TYPE>& workspace)
+     {
+       min_conv_Bussieck_et_al(a, b, result_begin, result_end, detail::null_iterator(), workspace);
+     } 
+
+     template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR, typename VALUE_TYPE>
+     void min_conv_Bussieck_et_al(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_workspace<VALUE_TYPE>& workspace)
+     {
+       min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator(), workspace);
+     } 
+
      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
      void min_conv_Bussieck_et_al(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end)
      {
-       using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
-       // define output iterators that will do nothing (for not recording optimal indices).
-       struct null_value {
-         null_value& operator=(VALUE_TYPE) { return *this; }
-       };
-       struct null_iterator {
-         null_value operator*() { return null_value(); }
-         null_value operator[](std::size_t) { return null_value(); }
-       } null_it;
-
-       min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end, null_it);
+       min_conv_Bussieck_et_al(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator());
      } 
 
 } // end namespace tropical_convolution
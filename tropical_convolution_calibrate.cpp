@@ -0,0 +1,41 @@
+#include "tropical_convolution_calibration.hxx"
+#include <iostream>
+#include <string>
+#include <cstdint>
+
+template<typename VALUE_TYPE>
+void calibrate(const char* name, const tropical_convolution::simd_level level)
+{
+  tropical_convolution::min_conv_calibrate<VALUE_TYPE>();
+  std::cout << name << " (simd level " << tropical_convolution::detail::simd_level_names[std::size_t(level)] << "):";
+  for(std::size_t r=0; r<tropical_convolution::min_conv_nr_ratio_buckets; ++r) {
+    const auto p = tropical_convolution::get_min_conv_parameters<VALUE_TYPE>(tropical_convolution::get_simd_level(), r);
+    std::cout << " ratio bucket " << r << ": threshold ";
+    if(p.naive_threshold == tropical_convolution::min_conv_always_naive) { std::cout << "always naive"; } else { std::cout << p.naive_threshold; }
+    std::cout << ", fallback ratio " << p.fallback_ratio << ";";
+  }
+  std::cout << std::endl;
+}
+
+// measure the parameters of min_conv for all value types and instruction sets of the host and write them to a profile file.
+// Use the profile by setting the environment variable TROPICAL_CONVOLUTION_PROFILE to its name, or by calling load_min_conv_profile.
+int main(int argc, char** argv)
+{
+  const std::string filename = argc > 1 ? argv[1] : "tropical_convolution.profile";
+  const auto host_level = tropical_convolution::get_simd_level();
+
+  for(int l=0; l<=int(host_level); ++l) {
+    const auto level = tropical_convolution::simd_level(l);
+    tropical_convolution::set_simd_level(level);
+    calibrate<float>("float", level);
+    calibrate<double>("double", level);
+    calibrate<std::int32_t>("int32", level);
+  }
+  // not vectorized, only calibrated once
+  tropical_convolution::set_simd_level(tropical_convolution::simd_level::none);
+  calibrate<std::int64_t>("int64", tropical_convolution::simd_level::none);
+  tropical_convolution::set_simd_level(host_level);
+
+  tropical_convolution::save_min_conv_profile(filename);
+  std::cout << "profile written to " << filename << std::endl;
+}
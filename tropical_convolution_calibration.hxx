@@ -0,0 +1,168 @@
+#ifndef TROPICAL_CONVOLUTION_CALIBRATION_HXX
+#define TROPICAL_CONVOLUTION_CALIBRATION_HXX
+
+#include "tropical_convolution.hxx"
+#include "tropical_convolution_tuning.hxx"
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <type_traits>
+#include <limits>
+#include <cmath>
+#include <tuple>
+#include <utility>
+#include <cassert>
+
+// measure the parameters in tropical_convolution_tuning.hxx on the host.
+// For every ratio bucket the fallback ratio of the method of Bussieck et al is chosen first, then the break even result size of the naive method and the method of Bussieck et al is searched.
+// Input is uniformly distributed, as in tropical_convolution_benchmark. Calibration of one value type takes a few seconds with the default maximal result size.
+
+namespace tropical_convolution {
+
+  namespace detail {
+
+       template<typename VALUE_TYPE>
+       std::vector<VALUE_TYPE> calibration_input(std::mt19937& gen, const std::size_t size, std::true_type)
+       {
+         std::uniform_int_distribution<VALUE_TYPE> dis(0, 1000000);
+         std::vector<VALUE_TYPE> x(size);
+         for(auto& v : x) { v = dis(gen); }
+         return x;
+       }
+
+       template<typename VALUE_TYPE>
+       std::vector<VALUE_TYPE> calibration_input(std::mt19937& gen, const std::size_t size, std::false_type)
+       {
+         std::uniform_real_distribution<VALUE_TYPE> dis(0.0, 10.0);
+         std::vector<VALUE_TYPE> x(size);
+         for(auto& v : x) { v = dis(gen); }
+         return x;
+       }
+
+       // seconds per call of f: minimum over three repetitions, each calling f often enough to take at least a millisecond.
+       template<typename F>
+       double calibration_time(F f)
+       {
+         using clock = std::chrono::steady_clock;
+         double best = std::numeric_limits<double>::max();
+         for(int rep=0; rep<3; ++rep) {
+           std::size_t nr_calls = 0;
+           const auto begin = clock::now();
+           auto end = begin;
+           do {
+             f();
+             ++nr_calls;
+             end = clock::now();
+           } while(end - begin < std::chrono::milliseconds(1));
+           best = std::min(best, std::chrono::duration<double>(end - begin).count() / nr_calls);
+         }
+         return best;
+       }
+
+       // sizes of operands whose sizes have the given ratio and whose full convolution has result_size entries.
+       inline std::pair<std::size_t, std::size_t> calibration_sizes(const std::size_t result_size, const std::size_t ratio)
+       {
+         const std::size_t a_size = std::max(std::size_t(2), (result_size+1) / (ratio+1));
+         const std::size_t b_size = std::max(std::size_t(2), result_size+1 - a_size);
+         return {a_size, b_size};
+       }
+
+       inline std::size_t calibration_bucket(const std::size_t result_size, const std::size_t ratio)
+       {
+         const auto sizes = calibration_sizes(result_size, ratio);
+         return ratio_bucket(sizes.first, sizes.second);
+       }
+
+       template<typename VALUE_TYPE>
+       struct calibration_problem {
+         calibration_problem(std::mt19937& gen, const std::size_t result_size, const std::size_t ratio)
+         {
+           std::size_t a_size, b_size;
+           std::tie(a_size, b_size) = calibration_sizes(result_size, ratio);
+           a = calibration_input<VALUE_TYPE>(gen, a_size, std::is_integral<VALUE_TYPE>());
+           b = calibration_input<VALUE_TYPE>(gen, b_size, std::is_integral<VALUE_TYPE>());
+           result.resize(a_size + b_size - 1);
+         }
+
+         double naive_time()
+         {
+           return calibration_time([&]() { min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end()); });
+         }
+
+         double Bussieck_et_al_time(min_conv_workspace<VALUE_TYPE>& workspace)
+         {
+           return calibration_time([&]() { min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), workspace); });
+         }
+
+         std::vector<VALUE_TYPE> a, b, result;
+       };
+
+  } // end namespace detail
+
+  // tune the parameters of VALUE_TYPE for the current simd level. Break even sizes are searched up to max_result_size.
+  // The parameters are stored in the table used by min_conv, save them with save_min_conv_profile.
+  template<typename VALUE_TYPE>
+  void min_conv_calibrate(const std::size_t max_result_size = std::size_t(1) << 17)
+  {
+    using ITERATOR = typename std::vector<VALUE_TYPE>::iterator;
+    const simd_level level = detail::effective_simd_level<ITERATOR, ITERATOR, ITERATOR>();
+    static const std::size_t bucket_ratio[min_conv_nr_ratio_buckets] = {1, 4, 16, 64};
+    static const double fallback_ratios[] = {0.01, 0.02, 0.04, 0.08, 0.16, 0.32};
+
+    std::mt19937 gen(1);
+    min_conv_workspace<VALUE_TYPE> workspace;
+    for(std::size_t r=0; r<min_conv_nr_ratio_buckets; ++r) {
+      min_conv_parameters p = get_min_conv_parameters<VALUE_TYPE>(level, r);
+
+      // fallback ratio at a size where the method of Bussieck et al is typically used
+      {
+        detail::calibration_problem<VALUE_TYPE> problem(gen, std::min(max_result_size, std::size_t(1) << 14), bucket_ratio[r]);
+        assert(detail::ratio_bucket(problem.a.size(), problem.b.size()) == r);
+        double best_time = std::numeric_limits<double>::max();
+        double best_ratio = min_conv_fallback_ratio;
+        for(const double ratio : fallback_ratios) {
+          p.fallback_ratio = ratio;
+          set_min_conv_parameters<VALUE_TYPE>(level, r, p);
+          const double t = problem.Bussieck_et_al_time(workspace);
+          if(t < best_time) {
+            best_time = t;
+            best_ratio = ratio;
+          }
+        }
+        p.fallback_ratio = best_ratio;
+        set_min_conv_parameters<VALUE_TYPE>(level, r, p);
+      }
+
+      // doubling search for the first size where the method of Bussieck et al wins, then bisection on a logarithmic scale.
+      // Small sizes are skipped when rounding the operand sizes puts them into another ratio bucket.
+      std::size_t lo = 0;
+      std::size_t hi = 64;
+      while(detail::calibration_bucket(hi, bucket_ratio[r]) != r) { hi *= 2; }
+      for(; hi <= max_result_size; lo = hi, hi *= 2) {
+        detail::calibration_problem<VALUE_TYPE> problem(gen, hi, bucket_ratio[r]);
+        assert(detail::ratio_bucket(problem.a.size(), problem.b.size()) == r);
+        if(problem.Bussieck_et_al_time(workspace) < problem.naive_time()) { break; }
+      }
+      if(hi > max_result_size) {
+        // the naive method won at all measured sizes
+        p.naive_threshold = min_conv_always_naive;
+        set_min_conv_parameters<VALUE_TYPE>(level, r, p);
+        continue;
+      }
+      if(lo > 0) {
+        for(int step=0; step<3 && hi > lo+1; ++step) {
+          const std::size_t mid = std::size_t(std::sqrt(double(lo) * double(hi)));
+          detail::calibration_problem<VALUE_TYPE> problem(gen, mid, bucket_ratio[r]);
+          assert(detail::ratio_bucket(problem.a.size(), problem.b.size()) == r);
+          if(problem.Bussieck_et_al_time(workspace) < problem.naive_time()) { hi = mid; } else { lo = mid; }
+        }
+      }
+      p.naive_threshold = hi;
+      set_min_conv_parameters<VALUE_TYPE>(level, r, p);
+    }
+  }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_CALIBRATION_HXX
@@ -0,0 +1,219 @@
+#ifndef TROPICAL_CONVOLUTION_CHAIN_HXX
+#define TROPICAL_CONVOLUTION_CHAIN_HXX
+
+#include "tropical_convolution.hxx"
+#include "tropical_convolution_batch.hxx"
+#include "tropical_convolution_parallel.hxx"
+#include "tropical_convolution_thread_pool.hxx"
+#include <iterator>
+#include <algorithm>
+#include <vector>
+#include <cassert>
+
+// min convolution of many operands a_0, ..., a_{n-1}: c[k] = min { a_0[i_0] + ... + a_{n-1}[i_{n-1}] : i_0 + ... + i_{n-1} = k }.
+// Operands are combined pairwise in a balanced tree, level by level. The nodes of one level are computed in parallel, or one after another with min_conv_parallel when there are fewer nodes than threads.
+// Every intermediate result is truncated to the length of the final result, since later entries cannot contribute to it. Levels alternate between two buffers.
+
+namespace tropical_convolution {
+
+  // back pointers of min_conv_chain, for recovering the indices into the operands that give each output.
+  // Node j of level l > 0 combines nodes 2j and 2j+1 of level l-1, or equals node 2j if that is the last one. Level 0 consists of the operands.
+  // arg_min[l][offset[l][j] + k] is the index into node 2j for output k of node j.
+  struct min_conv_chain_arg_min {
+    std::size_t nr_operands = 0;
+    std::vector<std::vector<std::size_t>> offset;
+    std::vector<std::vector<std::size_t>> arg_min;
+
+    // write the indices into all operands whose values sum up to output k of the chain.
+    template<typename OUTPUT_ITERATOR>
+    void split(const std::size_t k, OUTPUT_ITERATOR operand_index_begin) const
+    {
+      assert(nr_operands > 0);
+      std::vector<std::size_t> index = {k};
+      std::vector<std::size_t> child_index;
+      for(std::size_t l=offset.size()-1; l>0; --l) {
+        const std::size_t nr_children = l > 1 ? offset[l-1].size()-1 : nr_operands;
+        child_index.resize(nr_children);
+        for(std::size_t j=0; j<index.size(); ++j) {
+          if(2*j+1 < nr_children) {
+            const std::size_t i = arg_min[l][offset[l][j] + index[j]];
+            child_index[2*j] = i;
+            child_index[2*j+1] = index[j] - i;
+          } else {
+            child_index[2*j] = index[j];
+          }
+        }
+        std::swap(index, child_index);
+      }
+      assert(index.size() == nr_operands);
+      std::copy(index.begin(), index.end(), operand_index_begin);
+    }
+  };
+
+  namespace detail {
+
+       // min convolution also for operands of length one, which min_conv does not accept.
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename CONV>
+       void min_conv_chain_combine(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, CONV conv)
+       {
+         const std::size_t a_size = std::distance(a_begin, a_end);
+         const std::size_t b_size = std::distance(b_begin, b_end);
+         const std::size_t result_size = std::distance(result_begin, result_end);
+         if(a_size == 1) {
+           for(std::size_t k=0; k<result_size; ++k) {
+             result_begin[k] = a_begin[0] + b_begin[k];
+             result_index_a_begin[k] = 0;
+           }
+         } else if(b_size == 1) {
+           for(std::size_t k=0; k<result_size; ++k) {
+             result_begin[k] = a_begin[k] + b_begin[0];
+             result_index_a_begin[k] = k;
+           }
+         } else {
+           conv(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+         }
+       }
+
+       template<typename INPUT_RANGE_ITERATOR, typename OUTPUT_ITERATOR>
+       void min_conv_chain(INPUT_RANGE_ITERATOR operands_begin, INPUT_RANGE_ITERATOR operands_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_chain_arg_min* arg_min, thread_pool& pool)
+       {
+         using VALUE_TYPE = range_value_type<INPUT_RANGE_ITERATOR>;
+         const std::size_t nr_operands = std::distance(operands_begin, operands_end);
+         const std::size_t result_size = std::distance(result_begin, result_end);
+         assert(nr_operands > 0);
+
+         // level 0: the operands, truncated
+         std::vector<std::size_t> size(nr_operands);
+         std::size_t total_size = 0;
+         for(std::size_t m=0; m<nr_operands; ++m) {
+           const std::size_t operand_size = std::distance(std::begin(operands_begin[m]), std::end(operands_begin[m]));
+           assert(operand_size > 0);
+           total_size += operand_size - 1;
+           size[m] = std::min(operand_size, result_size);
+         }
+         assert(result_size <= total_size + 1);
+
+         if(arg_min != nullptr) {
+           arg_min->nr_operands = nr_operands;
+           arg_min->offset.assign(1, std::vector<std::size_t>());
+           arg_min->arg_min.assign(1, std::vector<std::size_t>());
+         }
+         if(nr_operands == 1) {
+           std::copy(std::begin(operands_begin[0]), std::begin(operands_begin[0]) + result_size, result_begin);
+           return;
+         }
+
+         std::vector<VALUE_TYPE> buffer[2];
+         std::vector<std::size_t> offset[2];
+         std::vector<min_conv_workspace<VALUE_TYPE>> workspaces(pool.size());
+         std::vector<std::size_t> no_arg_min;
+
+         std::size_t nr_nodes = nr_operands;
+         std::size_t last = 0;
+         for(std::size_t level=1; nr_nodes > 1; ++level) {
+           const std::size_t nr_next = (nr_nodes + 1) / 2;
+           auto& prev_buffer = buffer[level % 2];
+           auto& prev_offset = offset[level % 2];
+           auto& next_buffer = buffer[(level+1) % 2];
+           auto& next_offset = offset[(level+1) % 2];
+
+           next_offset.assign(nr_next + 1, 0);
+           for(std::size_t j=0; j<nr_next; ++j) {
+             const std::size_t next_size = 2*j+1 < nr_nodes ? std::min(result_size, size[2*j] + size[2*j+1] - 1) : size[2*j];
+             next_offset[j+1] = next_offset[j] + next_size;
+           }
+           next_buffer.resize(next_offset.back());
+           if(arg_min != nullptr) {
+             arg_min->offset.push_back(next_offset);
+             arg_min->arg_min.emplace_back(next_offset.back());
+           }
+           auto& level_arg_min = arg_min != nullptr ? arg_min->arg_min.back() : no_arg_min;
+
+           // node j of this level, computed with the given convolution
+           auto compute = [&](const std::size_t j, auto conv) {
+             auto out_begin = next_buffer.begin() + next_offset[j];
+             auto out_end = next_buffer.begin() + next_offset[j+1];
+             auto index_out = [&](auto index_begin) {
+               if(level == 1) {
+                 auto&& a = operands_begin[2*j];
+                 if(2*j+1 < nr_nodes) {
+                   auto&& b = operands_begin[2*j+1];
+                   min_conv_chain_combine(std::begin(a), std::begin(a) + size[2*j], std::begin(b), std::begin(b) + size[2*j+1], out_begin, out_end, index_begin, conv);
+                 } else {
+                   std::copy(std::begin(a), std::begin(a) + size[2*j], out_begin);
+                 }
+               } else {
+                 const auto a = prev_buffer.cbegin() + prev_offset[2*j];
+                 if(2*j+1 < nr_nodes) {
+                   const auto b = prev_buffer.cbegin() + prev_offset[2*j+1];
+                   min_conv_chain_combine(a, a + size[2*j], b, b + size[2*j+1], out_begin, out_end, index_begin, conv);
+                 } else {
+                   std::copy(a, a + size[2*j], out_begin);
+                 }
+               }
+             };
+             if(arg_min != nullptr) {
+               index_out(level_arg_min.begin() + next_offset[j]);
+             } else {
+               index_out(null_iterator());
+             }
+           };
+
+           if(nr_next >= pool.size()) {
+             pool.run(nr_next, [&](const std::size_t j, const std::size_t worker) {
+                 compute(j, [&](auto a_begin, auto a_end, auto b_begin, auto b_end, auto r_begin, auto r_end, auto index_begin) {
+                     min_conv(a_begin, a_end, b_begin, b_end, r_begin, r_end, index_begin, workspaces[worker]);
+                 });
+             });
+           } else {
+             for(std::size_t j=0; j<nr_next; ++j) {
+               compute(j, [&](auto a_begin, auto a_end, auto b_begin, auto b_end, auto r_begin, auto r_end, auto index_begin) {
+                   min_conv_parallel(a_begin, a_end, b_begin, b_end, r_begin, r_end, index_begin, pool);
+               });
+             }
+           }
+
+           for(std::size_t j=0; j<nr_next; ++j) { size[j] = next_offset[j+1] - next_offset[j]; }
+           size.resize(nr_next);
+           nr_nodes = nr_next;
+           last = (level+1) % 2;
+         }
+
+         assert(buffer[last].size() == result_size);
+         std::copy(buffer[last].begin(), buffer[last].end(), result_begin);
+       }
+
+  } // end namespace detail
+
+      // compute the min convolution of all operands in [operands_begin, operands_end) into result. Operands are ranges, e.g. std::vector or span, and must not be empty.
+      // The length of result determines how many values are computed, it must not exceed the length of the full convolution.
+      template<typename INPUT_RANGE_ITERATOR, typename OUTPUT_ITERATOR>
+      void min_conv_chain(INPUT_RANGE_ITERATOR operands_begin, INPUT_RANGE_ITERATOR operands_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, thread_pool& pool)
+      {
+        detail::min_conv_chain(operands_begin, operands_end, result_begin, result_end, nullptr, pool);
+      }
+
+      template<typename INPUT_RANGE_ITERATOR, typename OUTPUT_ITERATOR>
+      void min_conv_chain(INPUT_RANGE_ITERATOR operands_begin, INPUT_RANGE_ITERATOR operands_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end)
+      {
+        min_conv_chain(operands_begin, operands_end, result_begin, result_end, default_thread_pool());
+      }
+
+      // additionally store back pointers in arg_min, arg_min.split(k, ...) then gives the index into every operand for result[k].
+      template<typename INPUT_RANGE_ITERATOR, typename OUTPUT_ITERATOR>
+      void min_conv_chain(INPUT_RANGE_ITERATOR operands_begin, INPUT_RANGE_ITERATOR operands_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_chain_arg_min& arg_min, thread_pool& pool)
+      {
+        detail::min_conv_chain(operands_begin, operands_end, result_begin, result_end, &arg_min, pool);
+      }
+
+      template<typename INPUT_RANGE_ITERATOR, typename OUTPUT_ITERATOR>
+      void min_conv_chain(INPUT_RANGE_ITERATOR operands_begin, INPUT_RANGE_ITERATOR operands_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_chain_arg_min& arg_min)
+      {
+        min_conv_chain(operands_begin, operands_end, result_begin, result_end, arg_min, default_thread_pool());
+      }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_CHAIN_HXX
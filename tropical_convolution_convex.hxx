@@ -0,0 +1,348 @@
+#ifndef TROPICAL_CONVOLUTION_CONVEX_HXX
+#define TROPICAL_CONVOLUTION_CONVEX_HXX
+
+#include "min_sum.hxx"
+#include "tropical_convolution_simd.hxx"
+#include <limits>
+#include <cmath>
+#include <type_traits>
+#include <algorithm>
+#include <iterator>
+#include <vector>
+#include <cassert>
+
+// min convolution in linear time when the input has structure:
+// - both inputs convex: the slopes of the result are the sorted union of the slopes of the inputs (Minkowski sum), hence a merge suffices.
+// - one input convex: the matrix M[k][i] = a[i] + b[k-i] is Monge, its row minima are found with the SMAWK algorithm of
+//   A. Aggarwal, M. Klawe, S. Moran, P. Shor, R. Wilber: Geometric applications of a matrix-searching algorithm. Algorithmica, 2:195–208, 1987.
+// - both inputs concave: a[i] + b[k-i] is concave in i, hence the minimum is attained at one of the two ends of the admissible range.
+// For floating point input the selection is exact as long as the sums a[i] + b[j] are; otherwise results can differ from min_conv_naive in the last bit.
+// Rounding can make floating point values slightly non convex, e.g. a quadratic penalty stored as float. If both inputs lie within min_conv_convex_tolerance units in the last place
+// of their largest value above their lower convex hulls, the slopes of the hulls are merged instead. Every output is then a sum a[i] + b[k-i] exceeding the exact value by at most
+// the two distances.
+
+namespace tropical_convolution {
+
+  // distance from convexity attributed to rounding, in units of the last place of the largest absolute value of a floating point input.
+  static const double min_conv_convex_tolerance = 4.0;
+
+  namespace detail {
+
+       // a[i+1] - a[i] is nondecreasing. Fails on NaN differences, e.g. from infinities in the input.
+       template<typename ITERATOR>
+       bool is_convex(ITERATOR begin, ITERATOR end)
+       {
+         const auto size = std::distance(begin, end);
+         for(auto i=1; i+1<size; ++i) {
+           if(!(begin[i+1] - begin[i] >= begin[i] - begin[i-1])) {
+             return false;
+           }
+         }
+         return true;
+       }
+
+       template<typename ITERATOR>
+       bool is_concave(ITERATOR begin, ITERATOR end)
+       {
+         const auto size = std::distance(begin, end);
+         for(auto i=1; i+1<size; ++i) {
+           if(!(begin[i+1] - begin[i] <= begin[i] - begin[i-1])) {
+             return false;
+           }
+         }
+         return true;
+       }
+
+       // floating point input convex up to rounding: write the slopes of its lower convex hull to slopes, slopes[i] between i and i+1.
+       // Return false if a value is not finite or lies more than min_conv_convex_tolerance units in the last place above the hull.
+       template<typename ITERATOR>
+       bool nearly_convex_slopes(ITERATOR begin, ITERATOR end, std::vector<double>& slopes)
+       {
+         using VALUE_TYPE = typename std::iterator_traits<ITERATOR>::value_type;
+         const std::size_t size = std::distance(begin, end);
+         const double ulp = min_conv_convex_tolerance * std::numeric_limits<VALUE_TYPE>::epsilon();
+         auto val = [&](const std::size_t i) { return double(begin[i]); };
+
+         // local check with the tolerance of the three values involved, it stops at the first violation on unstructured input
+         double max_abs = size > 0 ? std::max(std::abs(val(0)), std::abs(val(size-1))) : 0.0;
+         for(std::size_t i=1; i+1<size; ++i) {
+           const double local_max = std::max({std::abs(val(i-1)), std::abs(val(i)), std::abs(val(i+1))});
+           if(!(val(i+1) - val(i) >= val(i) - val(i-1) - 2.0 * ulp * local_max)) { return false; }
+           max_abs = std::max(max_abs, local_max);
+         }
+         if(!std::isfinite(max_abs)) { return false; }
+
+         // lower convex hull by a monotone chain
+         std::vector<std::size_t> hull;
+         for(std::size_t i=0; i<size; ++i) {
+           while(hull.size() >= 2) {
+             const std::size_t u = hull[hull.size()-2];
+             const std::size_t v = hull.back();
+             if((val(v) - val(u)) * double(i - u) < (val(i) - val(u)) * double(v - u)) { break; }
+             hull.pop_back();
+           }
+           hull.push_back(i);
+         }
+
+         const double tolerance = ulp * max_abs;
+         slopes.resize(size > 0 ? size-1 : 0);
+         for(std::size_t h=0; h+1<hull.size(); ++h) {
+           const std::size_t u = hull[h];
+           const std::size_t v = hull[h+1];
+           const double slope = (val(v) - val(u)) / double(v - u);
+           for(std::size_t i=u; i<v; ++i) {
+             if(val(i) - (val(u) + slope * double(i - u)) > tolerance) { return false; }
+             slopes[i] = slope;
+           }
+         }
+         return true;
+       }
+
+       // merge the slopes of a and b, slope_a(i) between i and i+1 of a, likewise for b. Ties are broken towards larger indices of a.
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX, typename SLOPE_1, typename SLOPE_2>
+       void min_conv_merge_slopes(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, SLOPE_1 slope_a, SLOPE_2 slope_b)
+       {
+         const std::size_t a_size = std::distance(a_begin, a_end);
+         const std::size_t b_size = std::distance(b_begin, b_end);
+         const std::size_t result_size = std::distance(result_begin, result_end);
+
+         std::size_t i = 0;
+         std::size_t j = 0;
+         for(std::size_t k=0; k<result_size; ++k) {
+           result_begin[k] = a_begin[i] + b_begin[j];
+           result_index_a_begin[k] = i;
+           if(j+1 == b_size || (i+1 < a_size && slope_a(i) <= slope_b(j))) {
+             ++i;
+           } else {
+             ++j;
+           }
+         }
+       }
+
+       // compute for every row in rows the rightmost column in cols attaining the row minimum of the totally monotone matrix given by lookup.
+       template<typename LOOKUP>
+       void smawk(const std::vector<std::size_t>& rows, const std::vector<std::size_t>& cols, LOOKUP lookup, std::vector<std::size_t>& arg_min)
+       {
+         if(rows.empty()) { return; }
+
+         // reduce: remove columns that cannot contain a row minimum, leaving at most as many columns as rows.
+         std::vector<std::size_t> reduced;
+         reduced.reserve(rows.size());
+         for(const std::size_t c : cols) {
+           while(!reduced.empty()) {
+             const std::size_t r = rows[reduced.size()-1];
+             if(lookup(r, reduced.back()) < lookup(r, c)) { break; }
+             reduced.pop_back();
+           }
+           if(reduced.size() < rows.size()) {
+             reduced.push_back(c);
+           }
+         }
+
+         // recurse on every other row
+         std::vector<std::size_t> odd_rows;
+         odd_rows.reserve(rows.size()/2);
+         for(std::size_t r=1; r<rows.size(); r+=2) {
+           odd_rows.push_back(rows[r]);
+         }
+         smawk(odd_rows, reduced, lookup, arg_min);
+
+         // the minima of the remaining rows lie between the minima of their neighbours
+         std::size_t c = 0;
+         for(std::size_t r=0; r<rows.size(); r+=2) {
+           const std::size_t row = rows[r];
+           const std::size_t last = r+1 < rows.size() ? arg_min[rows[r+1]] : reduced.back();
+           std::size_t best = reduced[c];
+           auto best_val = lookup(row, best);
+           while(reduced[c] != last) {
+             ++c;
+             const auto val = lookup(row, reduced[c]);
+             if(val <= best_val) {
+               best = reduced[c];
+               best_val = val;
+             }
+           }
+           arg_min[row] = best;
+         }
+       }
+
+       // a arbitrary, b convex. result_index_a_begin receives the index into a.
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+       void min_conv_smawk(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+       {
+         using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+         const std::size_t a_size = std::distance(a_begin, a_end);
+         const std::size_t b_size = std::distance(b_begin, b_end);
+         const std::size_t result_size = std::distance(result_begin, result_end);
+
+         // entries outside of the band 0 <= k-i < b_size are infinite, which preserves the Monge property.
+         auto lookup = [&](const std::size_t k, const std::size_t i) -> VALUE_TYPE {
+           if(i > k || k-i >= b_size) { return infinity<VALUE_TYPE>(); }
+           return a_begin[i] + b_begin[k-i];
+         };
+
+         std::vector<std::size_t> rows(result_size);
+         for(std::size_t k=0; k<result_size; ++k) { rows[k] = k; }
+         std::vector<std::size_t> cols(std::min(a_size, result_size));
+         for(std::size_t i=0; i<cols.size(); ++i) { cols[i] = i; }
+
+         std::vector<std::size_t> arg_min(result_size);
+         smawk(rows, cols, lookup, arg_min);
+
+         for(std::size_t k=0; k<result_size; ++k) {
+           result_begin[k] = lookup(k, arg_min[k]);
+           result_index_a_begin[k] = arg_min[k];
+         }
+       }
+
+       // iterator writing k - j for every index j assigned to it, translating indices of b into indices of a.
+       template<typename OUTPUT_ITERATOR_INDEX>
+       struct complement_index_iterator {
+         struct reference {
+           OUTPUT_ITERATOR_INDEX it;
+           std::size_t k;
+           reference& operator=(const std::size_t j) { it[k] = k - j; return *this; }
+         };
+         OUTPUT_ITERATOR_INDEX it;
+         reference operator[](const std::size_t k) const { return reference{it, k}; }
+       };
+
+       template<typename OUTPUT_ITERATOR_INDEX>
+       complement_index_iterator<OUTPUT_ITERATOR_INDEX> make_complement_index_iterator(OUTPUT_ITERATOR_INDEX it)
+       {
+         return complement_index_iterator<OUTPUT_ITERATOR_INDEX>{it};
+       }
+
+  } // end namespace detail
+
+      // both a and b convex: merge the slopes of a and b. Ties are broken towards larger indices of a.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_convex_merge(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+      {
+        using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+        static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<INPUT_ITERATOR_2>::value_type>::value, "input iterators must have same value type");
+        static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<OUTPUT_ITERATOR_VAL>::value_type>::value, "input and output iterators must have same value type");
+
+        assert(std::distance(result_begin, result_end) <= std::distance(a_begin, a_end) + std::distance(b_begin, b_end) - 1);
+        assert(detail::is_convex(a_begin, a_end) && detail::is_convex(b_begin, b_end));
+
+        detail::min_conv_merge_slopes(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin,
+            [&](const std::size_t i) { return a_begin[i+1] - a_begin[i]; }, [&](const std::size_t j) { return b_begin[j+1] - b_begin[j]; });
+      }
+
+      // both a and b concave: the optimum is attained for the smallest or the largest admissible index of a. Ties are broken towards the larger one.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_concave(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+      {
+        using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+        static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<INPUT_ITERATOR_2>::value_type>::value, "input iterators must have same value type");
+        static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<OUTPUT_ITERATOR_VAL>::value_type>::value, "input and output iterators must have same value type");
+
+        const std::size_t a_size = std::distance(a_begin, a_end);
+        const std::size_t b_size = std::distance(b_begin, b_end);
+        const std::size_t result_size = std::distance(result_begin, result_end);
+        assert(result_size <= a_size + b_size - 1);
+        assert(detail::is_concave(a_begin, a_end) && detail::is_concave(b_begin, b_end));
+
+        for(std::size_t k=0; k<result_size; ++k) {
+          const std::size_t i_first = k+1 > b_size ? k+1-b_size : 0;
+          const std::size_t i_last = std::min(k, a_size-1);
+          const auto val_first = a_begin[i_first] + b_begin[k-i_first];
+          const auto val_last = a_begin[i_last] + b_begin[k-i_last];
+          if(val_last <= val_first) {
+            result_begin[k] = val_last;
+            result_index_a_begin[k] = i_last;
+          } else {
+            result_begin[k] = val_first;
+            result_index_a_begin[k] = i_first;
+          }
+        }
+      }
+
+  namespace detail {
+
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+       void min_conv_convex(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+           const bool a_convex, const bool b_convex)
+       {
+         assert(a_convex || b_convex);
+         if(a_convex && b_convex) {
+           min_conv_convex_merge(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+         } else if(b_convex) {
+           min_conv_smawk(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+         } else {
+           min_conv_smawk(b_begin, b_end, a_begin, a_end, result_begin, result_end, make_complement_index_iterator(result_index_a_begin));
+         }
+       }
+
+       // use one of the linear time algorithms above if the input is convex or concave. Return false otherwise.
+       // The checks stop at the first violation, hence they are cheap on unstructured input.
+       // SMAWK has a considerably larger constant than the merge, with use_smawk == false only the case of both inputs convex or concave is handled.
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+       bool min_conv_structured(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, const bool use_smawk)
+       {
+         const bool a_convex = is_convex(a_begin, a_end);
+         const bool b_convex = (a_convex || use_smawk) && is_convex(b_begin, b_end);
+         if((a_convex && b_convex) || (use_smawk && (a_convex || b_convex))) {
+           min_conv_convex(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, a_convex, b_convex);
+           return true;
+         }
+         if(is_concave(a_begin, a_end) && is_concave(b_begin, b_end)) {
+           min_conv_concave(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin);
+           return true;
+         }
+         if(std::is_floating_point<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type>::value) {
+           std::vector<double> a_slopes, b_slopes;
+           if(nearly_convex_slopes(a_begin, a_end, a_slopes) && nearly_convex_slopes(b_begin, b_end, b_slopes)) {
+             min_conv_merge_slopes(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin,
+                 [&](const std::size_t i) { return a_slopes[i]; }, [&](const std::size_t j) { return b_slopes[j]; });
+             return true;
+           }
+         }
+         return false;
+       }
+
+  } // end namespace detail
+
+      // at least one of a and b must be convex. Uses the slope merge if both are, otherwise SMAWK.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_convex(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+      {
+        using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+        static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<INPUT_ITERATOR_2>::value_type>::value, "input iterators must have same value type");
+        static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<OUTPUT_ITERATOR_VAL>::value_type>::value, "input and output iterators must have same value type");
+        assert(std::distance(result_begin, result_end) <= std::distance(a_begin, a_end) + std::distance(b_begin, b_end) - 1);
+
+        detail::min_conv_convex(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, detail::is_convex(a_begin, a_end), detail::is_convex(b_begin, b_end));
+      }
+
+      // only return values of min convolution.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+      void min_conv_convex(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end)
+      {
+        min_conv_convex(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator());
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+      void min_conv_concave(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end)
+      {
+        min_conv_concave(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator());
+      }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_CONVEX_HXX
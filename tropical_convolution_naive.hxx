@@ -6,32 +6,66 @@
 #include <algorithm>
 #include <tuple>
 #include <cassert>
+#include "tropical_convolution_simd.hxx"
 
 // implement naive min convolution with O(n^2) runtime.
-// to do: use SIMD
+// contiguous float, double and int32 input is handled by the vectorized kernel in tropical_convolution_simd.hxx, other input by the generic loops below.
+// Integer sums wrap around or overflow, integer input must satisfy detail::sums_fit.
 
 namespace tropical_convolution {
 
-      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
-      void min_conv_naive(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end)
+  namespace detail {
+
+      // compute the outputs [k_begin, k_end) of the naive min convolution, so that disjoint output ranges can be computed independently.
+      // Every output is computed exactly as for the whole range, hence the results do not depend on the partitioning.
+      template<bool WITH_INDEX, typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_naive_range(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, const std::size_t k_begin, const std::size_t k_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
       {
          using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
          static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<INPUT_ITERATOR_2>::value_type>::value, "input iterators must have same value type");
-         static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<OUTPUT_ITERATOR>::value_type>::value, "input and output iterators must have same value type");
+         static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<OUTPUT_ITERATOR_VAL>::value_type>::value, "input and output iterators must have same value type");
+
+         const std::size_t a_size = std::distance(a_begin, a_end);
+         const std::size_t b_size = std::distance(b_begin, b_end);
+         assert(k_begin <= k_end && k_end <= a_size + b_size - 1);
+
+         if(min_conv_naive_simd<WITH_INDEX>(a_begin, a_end, b_begin, b_end, result_begin, k_begin, k_end, result_index_a_begin)) { return; }
+
+         std::fill(result_begin + k_begin, result_begin + k_end, infinity<VALUE_TYPE>());
+
+         for(std::size_t i = k_begin+1 > b_size ? k_begin+1-b_size : 0; i<std::min(k_end, a_size); ++i) {
+            for(std::size_t j = k_begin > i ? k_begin-i : 0; j<std::min(b_size, k_end-i); ++j) {
+               const auto cur_val = a_begin[i] + b_begin[j];
+               if(WITH_INDEX) {
+                  if(cur_val <= result_begin[i+j]) {
+                     result_begin[i+j] = cur_val;
+                     result_index_a_begin[i+j] = i;
+                  }
+               } else {
+                  result_begin[i+j] = std::min(result_begin[i+j], cur_val);
+               }
+            }
+         }
+      }
 
+  } // end namespace detail
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+      void min_conv_naive(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end)
+      {
          const auto a_size = std::distance(a_begin, a_end);
          assert(a_size > 1);
          const auto b_size = std::distance(b_begin, b_end);
          assert(b_size > 1);
          const auto result_size = std::distance(result_begin, result_end);
          assert(result_size <= a_size + b_size - 1);
-         std::fill(result_begin, result_end, std::numeric_limits<VALUE_TYPE>::infinity());
+         assert(detail::sums_fit(a_begin, a_end, b_begin, b_end));
 
-         for(auto i=0; i<std::min(result_size, a_size); ++i) {
-            for(auto j=0; j<std::min(b_size, result_size-i); ++j) {
-               result_begin[i+j] = std::min(result_begin[i+j], a_begin[i] + b_begin[j]); 
-            }
-         }
+         // output indices are not recorded, pass a dummy iterator
+         std::size_t* no_index = nullptr;
+         detail::min_conv_naive_range<false>(a_begin, a_end, b_begin, b_end, result_begin, 0, result_size, no_index);
       }
 
       // additionally return the index coming from the first vector for the optimum convolution. 
@@ -40,27 +74,15 @@ namespace tropical_convolution {
           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, 
           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
       {
-         using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
-         static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<INPUT_ITERATOR_2>::value_type>::value, "input iterators must have same value type");
-         static_assert(std::is_same<VALUE_TYPE, typename std::iterator_traits<OUTPUT_ITERATOR_VAL>::value_type>::value, "input and output iterators must have same value type");
-
          const auto a_size = std::distance(a_begin, a_end);
          assert(a_size > 1);
          const auto b_size = std::distance(b_begin, b_end);
          assert(b_size > 1);
          const auto result_size = std::distance(result_begin, result_end);
          assert(result_size <= a_size + b_size - 1);
-         std::fill(result_begin, result_end, std::numeric_limits<VALUE_TYPE>::infinity());
+         assert(detail::sums_fit(a_begin, a_end, b_begin, b_end));
 
-         for(auto i=0; i<std::min(result_size, a_size); ++i) {
-            for(auto j=0; j<std::min(b_size, result_size - i); ++j) {
-               const auto cur_val = a_begin[i] + b_begin[j];
-               if(cur_val <= result_begin[i+j]) {
-                  result_begin[i+j] = a_begin[i] + b_begin[j];
-                  result_index_a_begin[i+j] = i;
-               }
-            }
-         } 
+         detail::min_conv_naive_range<true>(a_begin, a_end, b_begin, b_end, result_begin, 0, result_size, result_index_a_begin);
       }
 
 } // end namespace tropical_convolution
@@ -0,0 +1,121 @@
+#ifndef TROPICAL_CONVOLUTION_PARALLEL_HXX
+#define TROPICAL_CONVOLUTION_PARALLEL_HXX
+
+#include "tropical_convolution.hxx"
+#include "tropical_convolution_thread_pool.hxx"
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+
+// compute one large min convolution with several threads.
+// The result range is split into tiles that are computed independently: by the naive kernel, or by the explicit min sum computation that fills values left open by the method of Bussieck et al.
+// Every output is computed exactly as in the serial version, hence results (including optimal indices) agree bit for bit with it.
+// The heap phase of Bussieck et al enumerates sums in increasing order and is inherently sequential, only the sorting of both operands and the fill of missing values run in parallel.
+
+namespace tropical_convolution {
+
+  // largest number of outputs per tile. Output values and indices of one tile stay in the per-core cache.
+  static const std::size_t min_conv_parallel_tile = 4096;
+
+  namespace detail {
+
+       // call f(k_begin, k_end) for tiles partitioning [0,size). Tiles are multiples of 64 outputs, so that vectorized blocks are not split, and every worker gets several tiles for load balancing.
+       template<typename F>
+       void parallel_for_tiles(const std::size_t size, thread_pool& pool, F f)
+       {
+         const std::size_t nr_tiles_wanted = 4*pool.size();
+         std::size_t tile = (size + nr_tiles_wanted - 1) / nr_tiles_wanted;
+         tile = std::min(min_conv_parallel_tile, std::max(std::size_t(64), (tile + 63) / 64 * 64));
+         const std::size_t nr_tiles = (size + tile - 1) / tile;
+         pool.run(nr_tiles, [&](const std::size_t t, const std::size_t) {
+             f(t*tile, std::min(size, (t+1)*tile));
+         });
+       }
+
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+       void min_conv_naive_parallel(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, thread_pool& pool)
+       {
+         constexpr bool with_index = !std::is_same<OUTPUT_ITERATOR_INDEX, null_iterator>::value;
+         const std::size_t result_size = std::distance(result_begin, result_end);
+         assert(result_size <= std::size_t(std::distance(a_begin, a_end) + std::distance(b_begin, b_end) - 1));
+         parallel_for_tiles(result_size, pool, [&](const std::size_t k_begin, const std::size_t k_end) {
+             min_conv_naive_range<with_index>(a_begin, a_end, b_begin, b_end, result_begin, k_begin, k_end, result_index_a_begin);
+         });
+       }
+
+  } // end namespace detail
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+      void min_conv_naive_parallel(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, thread_pool& pool)
+      {
+        detail::min_conv_naive_parallel(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator(), pool);
+      }
+
+      // additionally return the index coming from the first vector for the optimum convolution.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_naive_parallel(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, thread_pool& pool)
+      {
+        detail::min_conv_naive_parallel(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, pool);
+      }
+
+      // both operands are sorted concurrently, missing values are filled by all workers.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_Bussieck_et_al_parallel(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin,
+          min_conv_workspace<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type>& workspace, thread_pool& pool)
+      {
+        pool.run(2, [&](const std::size_t t, const std::size_t) {
+            if(t == 0) {
+              detail::sort_indices(a_begin, a_end, workspace.idx_a);
+            } else {
+              detail::sort_indices(b_begin, b_end, workspace.idx_b);
+            }
+        });
+        detail::null_statistics statistics;
+        detail::min_conv_Bussieck_et_al(a_begin, a_end, workspace.idx_a, b_begin, b_end, workspace.idx_b, result_begin, result_end, result_index_a_begin, workspace, statistics, [&]() {
+            detail::parallel_for_tiles(std::distance(result_begin, result_end), pool, [&](const std::size_t k_begin, const std::size_t k_end) {
+                detail::min_sum_missing(a_begin, a_end, b_begin, b_end, result_begin, k_begin, k_end, result_index_a_begin, workspace.assigned);
+            });
+        });
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR, typename VALUE_TYPE>
+      void min_conv_Bussieck_et_al_parallel(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, min_conv_workspace<VALUE_TYPE>& workspace, thread_pool& pool)
+      {
+        min_conv_Bussieck_et_al_parallel(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator(), workspace, pool);
+      }
+
+      // same algorithm selection as min_conv, but the naive method and the method of Bussieck et al run on all workers of the pool.
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+      void min_conv_parallel(
+          INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+          OUTPUT_ITERATOR_VAL result_begin, OUTPUT_ITERATOR_VAL result_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, thread_pool& pool)
+      {
+        detail::min_conv_dispatch(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin,
+            [&]() { detail::min_conv_naive_parallel(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, pool); },
+            [&]() {
+              min_conv_workspace<typename std::iterator_traits<INPUT_ITERATOR_1>::value_type> workspace;
+              min_conv_Bussieck_et_al_parallel(a_begin, a_end, b_begin, b_end, result_begin, result_end, result_index_a_begin, workspace, pool);
+            });
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+      void min_conv_parallel(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end, thread_pool& pool)
+      {
+        min_conv_parallel(a_begin, a_end, b_begin, b_end, result_begin, result_end, detail::null_iterator(), pool);
+      }
+
+      template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+      void min_conv_parallel(INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end, OUTPUT_ITERATOR result_begin, OUTPUT_ITERATOR result_end)
+      {
+        min_conv_parallel(a_begin, a_end, b_begin, b_end, result_begin, result_end, default_thread_pool());
+      }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_PARALLEL_HXX
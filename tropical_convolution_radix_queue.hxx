@@ -0,0 +1,112 @@
+#ifndef TROPICAL_CONVOLUTION_RADIX_QUEUE_HXX
+#define TROPICAL_CONVOLUTION_RADIX_QUEUE_HXX
+
+#include <array>
+#include <algorithm>
+#include <vector>
+#include <limits>
+#include <type_traits>
+#include <cstdint>
+#include <cassert>
+
+// monotone priority queue for integer keys (radix heap), see
+// R. K. Ahuja, K. Mehlhorn, J. B. Orlin, and R. E. Tarjan:
+// Faster algorithms for the shortest path problem.
+// Journal of the ACM, 37(2):213–223, 1990
+// Keys pushed must not be smaller than the last key popped, which holds in the method of Bussieck et al since sums are enumerated in increasing order.
+// An element is moved between buckets at most once per bit of the key, push and pop take amortized constant time without comparisons of whole keys.
+
+namespace tropical_convolution {
+
+  namespace detail {
+
+       // ELEMENT must have a member val of integral type, which is the key.
+       template<typename ELEMENT>
+       class radix_queue {
+         public:
+           using value_type = decltype(ELEMENT::val);
+           static_assert(std::is_integral<value_type>::value, "radix queue needs integral keys");
+           static_assert(std::numeric_limits<value_type>::digits <= 64, "keys must fit into 64 bits");
+
+           void push(const ELEMENT& e)
+           {
+             const auto k = key(e.val);
+             assert(k >= last_);
+             buckets_[bucket(k)].push_back(e);
+             ++size_;
+           }
+
+           const ELEMENT& top()
+           {
+             assert(!empty());
+             if(buckets_[0].empty()) { redistribute(); }
+             return buckets_[0].back();
+           }
+
+           void pop()
+           {
+             top();
+             buckets_[0].pop_back();
+             --size_;
+           }
+
+           std::size_t size() const { return size_; }
+           bool empty() const { return size_ == 0; }
+
+           void clear()
+           {
+             for(auto& b : buckets_) { b.clear(); }
+             last_ = 0;
+             size_ = 0;
+           }
+
+         private:
+           using key_type = typename std::make_unsigned<value_type>::type;
+           static constexpr std::size_t nr_bits = std::numeric_limits<key_type>::digits;
+
+           // order preserving map to unsigned keys: flip the sign bit of signed types.
+           static key_type key(const value_type v)
+           {
+             return std::is_signed<value_type>::value ? key_type(key_type(v) ^ (key_type(1) << (nr_bits-1))) : key_type(v);
+           }
+
+           // bucket 0 holds keys equal to last_, bucket b > 0 keys whose highest bit differing from last_ is b-1.
+           std::size_t bucket(const key_type k) const
+           {
+             return k == last_ ? 0 : bit_width(std::uint64_t(k ^ last_));
+           }
+
+           // number of bits needed to represent x > 0
+           static std::size_t bit_width(std::uint64_t x)
+           {
+#if defined(__GNUC__)
+             return 64 - __builtin_clzll(x);
+#else
+             std::size_t width = 0;
+             for(; x != 0; x >>= 1) { ++width; }
+             return width;
+#endif
+           }
+
+           // the smallest key of the first non-empty bucket becomes last_. All elements of that bucket then move to lower buckets.
+           void redistribute()
+           {
+             std::size_t b = 1;
+             while(buckets_[b].empty()) { ++b; }
+             key_type new_last = key(buckets_[b][0].val);
+             for(const auto& e : buckets_[b]) { new_last = std::min(new_last, key(e.val)); }
+             last_ = new_last;
+             for(const auto& e : buckets_[b]) { buckets_[bucket(key(e.val))].push_back(e); }
+             buckets_[b].clear();
+           }
+
+           std::array<std::vector<ELEMENT>, nr_bits+1> buckets_;
+           key_type last_ = 0;
+           std::size_t size_ = 0;
+       };
+
+  } // end namespace detail
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_RADIX_QUEUE_HXX
@@ -0,0 +1,522 @@
+#ifndef TROPICAL_CONVOLUTION_SIMD_HXX
+#define TROPICAL_CONVOLUTION_SIMD_HXX
+
+#include <limits>
+#include <algorithm>
+#include <iterator>
+#include <type_traits>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+#include "min_sum.hxx"
+
+// vectorized kernel for the naive min convolution on contiguous float, double and int32 input.
+// A block of output values is kept fixed in registers while a[i] is broadcast and b is streamed along the diagonal b[k-i].
+// AVX2 and AVX-512 versions are compiled side by side via function target attributes and the best one supported by the host is chosen at runtime.
+// Define TROPICAL_CONVOLUTION_NO_SIMD to always use the generic iterator implementation.
+
+#if !defined(TROPICAL_CONVOLUTION_NO_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define TROPICAL_CONVOLUTION_X86_SIMD
+#include <immintrin.h>
+#define TROPICAL_CONVOLUTION_TARGET_AVX2 __attribute__((target("avx2")))
+#define TROPICAL_CONVOLUTION_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+namespace tropical_convolution {
+
+  enum class simd_level { none, avx2, avx512 };
+
+  namespace detail {
+
+       inline simd_level detect_simd_level()
+       {
+#ifdef TROPICAL_CONVOLUTION_X86_SIMD
+         if(__builtin_cpu_supports("avx512f")) { return simd_level::avx512; }
+         if(__builtin_cpu_supports("avx2")) { return simd_level::avx2; }
+#endif
+         return simd_level::none;
+       }
+
+       inline simd_level& active_simd_level()
+       {
+         static simd_level level = detect_simd_level();
+         return level;
+       }
+
+       template<typename ITERATOR>
+       struct is_contiguous_iterator {
+         using VALUE_TYPE = typename std::remove_const<typename std::iterator_traits<ITERATOR>::value_type>::type;
+         static constexpr bool value = std::is_pointer<ITERATOR>::value
+           || std::is_same<ITERATOR, typename std::vector<VALUE_TYPE>::iterator>::value
+           || std::is_same<ITERATOR, typename std::vector<VALUE_TYPE>::const_iterator>::value;
+       };
+
+       template<typename VALUE_TYPE>
+       struct is_simd_value_type {
+         static constexpr bool value = std::is_same<VALUE_TYPE, float>::value || std::is_same<VALUE_TYPE, double>::value || std::is_same<VALUE_TYPE, std::int32_t>::value;
+       };
+
+       // whether min_conv_naive can use the vectorized kernel for the given iterators.
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+       struct is_simd_eligible {
+         using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+         static constexpr bool value = is_simd_value_type<VALUE_TYPE>::value
+           && is_contiguous_iterator<INPUT_ITERATOR_1>::value && is_contiguous_iterator<INPUT_ITERATOR_2>::value && is_contiguous_iterator<OUTPUT_ITERATOR>::value;
+       };
+
+#ifdef TROPICAL_CONVOLUTION_X86_SIMD
+
+       template<typename VALUE_TYPE> struct avx2_ops;
+       template<typename VALUE_TYPE> struct avx512_ops;
+
+       // Operations on one vector of values. Indices of the optimal entry of a are kept in a vector of the same type, hence they are only exact up to 2^digits.
+       // The masked variants only take lanes l into account for which first_j + l is a valid index into b.
+
+       template<>
+       struct avx2_ops<float> {
+         using value_type = float;
+         using vec = __m256;
+         using mask = __m256i;
+         static constexpr std::size_t width = 8;
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec set1(const float x) { return _mm256_set1_ps(x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec add(const vec x, const vec y) { return _mm256_add_ps(x, y); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec load(const float* p) { return _mm256_loadu_ps(p); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void store(float* p, const vec x) { _mm256_storeu_ps(p, x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static mask valid(const std::ptrdiff_t first_j, const std::ptrdiff_t b_size)
+         {
+           const __m256i j = _mm256_add_epi32(_mm256_set1_epi32(std::int32_t(first_j)), _mm256_setr_epi32(0,1,2,3,4,5,6,7));
+           return _mm256_and_si256(_mm256_cmpgt_epi32(j, _mm256_set1_epi32(-1)), _mm256_cmpgt_epi32(_mm256_set1_epi32(std::int32_t(b_size)), j));
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec load(const float* p, const mask m) { return _mm256_maskload_ps(p, m); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void min(vec& best, const vec cur) { best = _mm256_min_ps(best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void min(vec& best, const vec cur, const mask m)
+         {
+           best = _mm256_blendv_ps(best, _mm256_min_ps(best, cur), _mm256_castsi256_ps(m));
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx)
+         {
+           const vec le = _mm256_cmp_ps(cur, best, _CMP_LE_OQ);
+           best = _mm256_blendv_ps(best, cur, le);
+           best_idx = _mm256_blendv_ps(best_idx, cur_idx, le);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx, const mask m)
+         {
+           const vec le = _mm256_and_ps(_mm256_cmp_ps(cur, best, _CMP_LE_OQ), _mm256_castsi256_ps(m));
+           best = _mm256_blendv_ps(best, cur, le);
+           best_idx = _mm256_blendv_ps(best_idx, cur_idx, le);
+         }
+       };
+
+       template<>
+       struct avx2_ops<double> {
+         using value_type = double;
+         using vec = __m256d;
+         using mask = __m256i;
+         static constexpr std::size_t width = 4;
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec set1(const double x) { return _mm256_set1_pd(x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec add(const vec x, const vec y) { return _mm256_add_pd(x, y); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec load(const double* p) { return _mm256_loadu_pd(p); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void store(double* p, const vec x) { _mm256_storeu_pd(p, x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static mask valid(const std::ptrdiff_t first_j, const std::ptrdiff_t b_size)
+         {
+           const __m256i j = _mm256_add_epi64(_mm256_set1_epi64x(first_j), _mm256_setr_epi64x(0,1,2,3));
+           return _mm256_and_si256(_mm256_cmpgt_epi64(j, _mm256_set1_epi64x(-1)), _mm256_cmpgt_epi64(_mm256_set1_epi64x(b_size), j));
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec load(const double* p, const mask m) { return _mm256_maskload_pd(p, m); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void min(vec& best, const vec cur) { best = _mm256_min_pd(best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void min(vec& best, const vec cur, const mask m)
+         {
+           best = _mm256_blendv_pd(best, _mm256_min_pd(best, cur), _mm256_castsi256_pd(m));
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx)
+         {
+           const vec le = _mm256_cmp_pd(cur, best, _CMP_LE_OQ);
+           best = _mm256_blendv_pd(best, cur, le);
+           best_idx = _mm256_blendv_pd(best_idx, cur_idx, le);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx, const mask m)
+         {
+           const vec le = _mm256_and_pd(_mm256_cmp_pd(cur, best, _CMP_LE_OQ), _mm256_castsi256_pd(m));
+           best = _mm256_blendv_pd(best, cur, le);
+           best_idx = _mm256_blendv_pd(best_idx, cur_idx, le);
+         }
+       };
+
+       template<>
+       struct avx2_ops<std::int32_t> {
+         using value_type = std::int32_t;
+         using vec = __m256i;
+         using mask = __m256i;
+         static constexpr std::size_t width = 8;
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec set1(const std::int32_t x) { return _mm256_set1_epi32(x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec add(const vec x, const vec y) { return _mm256_add_epi32(x, y); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec load(const std::int32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void store(std::int32_t* p, const vec x) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static mask valid(const std::ptrdiff_t first_j, const std::ptrdiff_t b_size)
+         {
+           return avx2_ops<float>::valid(first_j, b_size);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static vec load(const std::int32_t* p, const mask m) { return _mm256_maskload_epi32(reinterpret_cast<const int*>(p), m); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void min(vec& best, const vec cur) { best = _mm256_min_epi32(best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void min(vec& best, const vec cur, const mask m)
+         {
+           best = _mm256_blendv_epi8(best, _mm256_min_epi32(best, cur), m);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx)
+         {
+           const vec gt = _mm256_cmpgt_epi32(cur, best);
+           best = _mm256_blendv_epi8(cur, best, gt);
+           best_idx = _mm256_blendv_epi8(cur_idx, best_idx, gt);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx, const mask m)
+         {
+           const vec le = _mm256_andnot_si256(_mm256_cmpgt_epi32(cur, best), m);
+           best = _mm256_blendv_epi8(best, cur, le);
+           best_idx = _mm256_blendv_epi8(best_idx, cur_idx, le);
+         }
+       };
+
+       template<>
+       struct avx512_ops<float> {
+         using value_type = float;
+         using vec = __m512;
+         using mask = __mmask16;
+         static constexpr std::size_t width = 16;
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec set1(const float x) { return _mm512_set1_ps(x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec add(const vec x, const vec y) { return _mm512_add_ps(x, y); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec load(const float* p) { return _mm512_loadu_ps(p); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void store(float* p, const vec x) { _mm512_storeu_ps(p, x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static mask valid(const std::ptrdiff_t first_j, const std::ptrdiff_t b_size)
+         {
+           // negative indices wrap around and are rejected by the unsigned comparison
+           const __m512i j = _mm512_add_epi32(_mm512_set1_epi32(std::int32_t(first_j)), _mm512_set_epi32(15,14,13,12,11,10,9,8,7,6,5,4,3,2,1,0));
+           return _mm512_cmplt_epu32_mask(j, _mm512_set1_epi32(std::int32_t(b_size)));
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec load(const float* p, const mask m) { return _mm512_maskz_loadu_ps(m, p); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void min(vec& best, const vec cur) { best = _mm512_min_ps(best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void min(vec& best, const vec cur, const mask m) { best = _mm512_mask_min_ps(best, m, best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx)
+         {
+           const mask le = _mm512_cmp_ps_mask(cur, best, _CMP_LE_OQ);
+           best = _mm512_mask_blend_ps(le, best, cur);
+           best_idx = _mm512_mask_blend_ps(le, best_idx, cur_idx);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx, const mask m)
+         {
+           const mask le = _mm512_mask_cmp_ps_mask(m, cur, best, _CMP_LE_OQ);
+           best = _mm512_mask_blend_ps(le, best, cur);
+           best_idx = _mm512_mask_blend_ps(le, best_idx, cur_idx);
+         }
+       };
+
+       template<>
+       struct avx512_ops<double> {
+         using value_type = double;
+         using vec = __m512d;
+         using mask = __mmask8;
+         static constexpr std::size_t width = 8;
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec set1(const double x) { return _mm512_set1_pd(x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec add(const vec x, const vec y) { return _mm512_add_pd(x, y); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec load(const double* p) { return _mm512_loadu_pd(p); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void store(double* p, const vec x) { _mm512_storeu_pd(p, x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static mask valid(const std::ptrdiff_t first_j, const std::ptrdiff_t b_size)
+         {
+           const __m512i j = _mm512_add_epi64(_mm512_set1_epi64(first_j), _mm512_set_epi64(7,6,5,4,3,2,1,0));
+           return _mm512_cmplt_epu64_mask(j, _mm512_set1_epi64(b_size));
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec load(const double* p, const mask m) { return _mm512_maskz_loadu_pd(m, p); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void min(vec& best, const vec cur) { best = _mm512_min_pd(best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void min(vec& best, const vec cur, const mask m) { best = _mm512_mask_min_pd(best, m, best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx)
+         {
+           const mask le = _mm512_cmp_pd_mask(cur, best, _CMP_LE_OQ);
+           best = _mm512_mask_blend_pd(le, best, cur);
+           best_idx = _mm512_mask_blend_pd(le, best_idx, cur_idx);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx, const mask m)
+         {
+           const mask le = _mm512_mask_cmp_pd_mask(m, cur, best, _CMP_LE_OQ);
+           best = _mm512_mask_blend_pd(le, best, cur);
+           best_idx = _mm512_mask_blend_pd(le, best_idx, cur_idx);
+         }
+       };
+
+       template<>
+       struct avx512_ops<std::int32_t> {
+         using value_type = std::int32_t;
+         using vec = __m512i;
+         using mask = __mmask16;
+         static constexpr std::size_t width = 16;
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec set1(const std::int32_t x) { return _mm512_set1_epi32(x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec add(const vec x, const vec y) { return _mm512_add_epi32(x, y); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec load(const std::int32_t* p) { return _mm512_loadu_si512(p); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void store(std::int32_t* p, const vec x) { _mm512_storeu_si512(p, x); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static mask valid(const std::ptrdiff_t first_j, const std::ptrdiff_t b_size)
+         {
+           return avx512_ops<float>::valid(first_j, b_size);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static vec load(const std::int32_t* p, const mask m) { return _mm512_maskz_loadu_epi32(m, p); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void min(vec& best, const vec cur) { best = _mm512_min_epi32(best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void min(vec& best, const vec cur, const mask m) { best = _mm512_mask_min_epi32(best, m, best, cur); }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx)
+         {
+           const mask le = _mm512_cmple_epi32_mask(cur, best);
+           best = _mm512_mask_blend_epi32(le, best, cur);
+           best_idx = _mm512_mask_blend_epi32(le, best_idx, cur_idx);
+         }
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void arg_min(vec& best, vec& best_idx, const vec cur, const vec cur_idx, const mask m)
+         {
+           const mask le = _mm512_mask_cmple_epi32_mask(m, cur, best);
+           best = _mm512_mask_blend_epi32(le, best, cur);
+           best_idx = _mm512_mask_blend_epi32(le, best_idx, cur_idx);
+         }
+       };
+
+       // Process UNROLL consecutive vectors of output values starting at k0. For i in [d_begin,d_end) all lanes have a valid partner in b,
+       // for the remaining i in [i_begin,i_end) lanes are masked. Indices i are visited in increasing order and ties are resolved as in the scalar version.
+       // The two kernels are identical except for the target attribute.
+       template<typename VALUE_TYPE>
+       struct avx2_kernel {
+         using ops = avx2_ops<VALUE_TYPE>;
+         static constexpr std::size_t width = ops::width;
+
+         template<std::size_t UNROLL, bool WITH_INDEX>
+         TROPICAL_CONVOLUTION_TARGET_AVX2 static void block(
+             const VALUE_TYPE* a, const VALUE_TYPE* b, const std::size_t b_size, VALUE_TYPE* result, VALUE_TYPE* result_index,
+             const std::size_t k0, const std::size_t i_begin, const std::size_t d_begin, const std::size_t d_end, const std::size_t i_end)
+         {
+           typename ops::vec val[UNROLL];
+           typename ops::vec idx[UNROLL];
+#pragma GCC unroll 4
+           for(std::size_t u=0; u<UNROLL; ++u) {
+             val[u] = ops::load(result + u*width);
+             if(WITH_INDEX) { idx[u] = ops::load(result_index + u*width); }
+           }
+           for(std::size_t i=i_begin; i<d_begin; ++i) {
+             const auto a_i = ops::set1(a[i]);
+             const auto cur_idx = ops::set1(VALUE_TYPE(i));
+#pragma GCC unroll 4
+             for(std::size_t u=0; u<UNROLL; ++u) {
+               const std::ptrdiff_t j = std::ptrdiff_t(k0 + u*width) - std::ptrdiff_t(i);
+               const auto m = ops::valid(j, b_size);
+               const auto cur = ops::add(a_i, ops::load(b + j, m));
+               if(WITH_INDEX) { ops::arg_min(val[u], idx[u], cur, cur_idx, m); } else { ops::min(val[u], cur, m); }
+             }
+           }
+           for(std::size_t i=d_begin; i<d_end; ++i) {
+             const auto a_i = ops::set1(a[i]);
+             const auto cur_idx = ops::set1(VALUE_TYPE(i));
+#pragma GCC unroll 4
+             for(std::size_t u=0; u<UNROLL; ++u) {
+               const auto cur = ops::add(a_i, ops::load(b + (k0 + u*width - i)));
+               if(WITH_INDEX) { ops::arg_min(val[u], idx[u], cur, cur_idx); } else { ops::min(val[u], cur); }
+             }
+           }
+           for(std::size_t i=d_end; i<i_end; ++i) {
+             const auto a_i = ops::set1(a[i]);
+             const auto cur_idx = ops::set1(VALUE_TYPE(i));
+#pragma GCC unroll 4
+             for(std::size_t u=0; u<UNROLL; ++u) {
+               const std::ptrdiff_t j = std::ptrdiff_t(k0 + u*width) - std::ptrdiff_t(i);
+               const auto m = ops::valid(j, b_size);
+               const auto cur = ops::add(a_i, ops::load(b + j, m));
+               if(WITH_INDEX) { ops::arg_min(val[u], idx[u], cur, cur_idx, m); } else { ops::min(val[u], cur, m); }
+             }
+           }
+#pragma GCC unroll 4
+           for(std::size_t u=0; u<UNROLL; ++u) {
+             ops::store(result + u*width, val[u]);
+             if(WITH_INDEX) { ops::store(result_index + u*width, idx[u]); }
+           }
+         }
+       };
+
+       template<typename VALUE_TYPE>
+       struct avx512_kernel {
+         using ops = avx512_ops<VALUE_TYPE>;
+         static constexpr std::size_t width = ops::width;
+
+         template<std::size_t UNROLL, bool WITH_INDEX>
+         TROPICAL_CONVOLUTION_TARGET_AVX512 static void block(
+             const VALUE_TYPE* a, const VALUE_TYPE* b, const std::size_t b_size, VALUE_TYPE* result, VALUE_TYPE* result_index,
+             const std::size_t k0, const std::size_t i_begin, const std::size_t d_begin, const std::size_t d_end, const std::size_t i_end)
+         {
+           typename ops::vec val[UNROLL];
+           typename ops::vec idx[UNROLL];
+#pragma GCC unroll 4
+           for(std::size_t u=0; u<UNROLL; ++u) {
+             val[u] = ops::load(result + u*width);
+             if(WITH_INDEX) { idx[u] = ops::load(result_index + u*width); }
+           }
+           for(std::size_t i=i_begin; i<d_begin; ++i) {
+             const auto a_i = ops::set1(a[i]);
+             const auto cur_idx = ops::set1(VALUE_TYPE(i));
+#pragma GCC unroll 4
+             for(std::size_t u=0; u<UNROLL; ++u) {
+               const std::ptrdiff_t j = std::ptrdiff_t(k0 + u*width) - std::ptrdiff_t(i);
+               const auto m = ops::valid(j, b_size);
+               const auto cur = ops::add(a_i, ops::load(b + j, m));
+               if(WITH_INDEX) { ops::arg_min(val[u], idx[u], cur, cur_idx, m); } else { ops::min(val[u], cur, m); }
+             }
+           }
+           for(std::size_t i=d_begin; i<d_end; ++i) {
+             const auto a_i = ops::set1(a[i]);
+             const auto cur_idx = ops::set1(VALUE_TYPE(i));
+#pragma GCC unroll 4
+             for(std::size_t u=0; u<UNROLL; ++u) {
+               const auto cur = ops::add(a_i, ops::load(b + (k0 + u*width - i)));
+               if(WITH_INDEX) { ops::arg_min(val[u], idx[u], cur, cur_idx); } else { ops::min(val[u], cur); }
+             }
+           }
+           for(std::size_t i=d_end; i<i_end; ++i) {
+             const auto a_i = ops::set1(a[i]);
+             const auto cur_idx = ops::set1(VALUE_TYPE(i));
+#pragma GCC unroll 4
+             for(std::size_t u=0; u<UNROLL; ++u) {
+               const std::ptrdiff_t j = std::ptrdiff_t(k0 + u*width) - std::ptrdiff_t(i);
+               const auto m = ops::valid(j, b_size);
+               const auto cur = ops::add(a_i, ops::load(b + j, m));
+               if(WITH_INDEX) { ops::arg_min(val[u], idx[u], cur, cur_idx, m); } else { ops::min(val[u], cur, m); }
+             }
+           }
+#pragma GCC unroll 4
+           for(std::size_t u=0; u<UNROLL; ++u) {
+             ops::store(result + u*width, val[u]);
+             if(WITH_INDEX) { ops::store(result_index + u*width, idx[u]); }
+           }
+         }
+       };
+
+       template<typename KERNEL, std::size_t UNROLL, bool WITH_INDEX, typename VALUE_TYPE, typename OUTPUT_ITERATOR_INDEX>
+       void min_conv_naive_block(
+           const VALUE_TYPE* a, const std::size_t a_size, const VALUE_TYPE* b, const std::size_t b_size,
+           VALUE_TYPE* result, const std::size_t k0, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+       {
+         constexpr std::size_t block_size = UNROLL*KERNEL::width;
+         VALUE_TYPE block_index[block_size] = {};
+
+         // indices of a contributing to some output in the block, and the subrange where all outputs have a partner in b.
+         const std::size_t i_begin = k0+1 > b_size ? k0+1-b_size : 0;
+         const std::size_t i_end = std::min(a_size, k0+block_size);
+         std::size_t d_begin = std::max(i_begin, k0+block_size > b_size ? k0+block_size-b_size : 0);
+         std::size_t d_end = std::min(i_end, k0+1);
+         if(d_begin >= d_end) {
+           d_begin = i_end;
+           d_end = i_end;
+         }
+
+         KERNEL::template block<UNROLL, WITH_INDEX>(a, b, b_size, result + k0, block_index, k0, i_begin, d_begin, d_end, i_end);
+
+         if(WITH_INDEX) {
+           for(std::size_t l=0; l<block_size; ++l) {
+             result_index_a_begin[k0+l] = std::size_t(block_index[l]);
+           }
+         }
+       }
+
+       // compute the outputs [k_begin, k_end).
+       template<typename KERNEL, bool WITH_INDEX, typename VALUE_TYPE, typename OUTPUT_ITERATOR_INDEX>
+       void min_conv_naive_simd(
+           const VALUE_TYPE* a, const std::size_t a_size, const VALUE_TYPE* b, const std::size_t b_size,
+           VALUE_TYPE* result, const std::size_t k_begin, const std::size_t k_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+       {
+         constexpr std::size_t width = KERNEL::width;
+         std::fill(result + k_begin, result + k_end, infinity<VALUE_TYPE>());
+
+         std::size_t k = k_begin;
+         for(; k + 4*width <= k_end; k += 4*width) {
+           min_conv_naive_block<KERNEL, 4, WITH_INDEX>(a, a_size, b, b_size, result, k, result_index_a_begin);
+         }
+         for(; k + width <= k_end; k += width) {
+           min_conv_naive_block<KERNEL, 1, WITH_INDEX>(a, a_size, b, b_size, result, k, result_index_a_begin);
+         }
+         // remaining outputs that do not fill a whole vector
+         for(; k<k_end; ++k) {
+           for(std::size_t i = k+1 > b_size ? k+1-b_size : 0; i<std::min(a_size, k+1); ++i) {
+             const auto cur_val = a[i] + b[k-i];
+             if(WITH_INDEX) {
+               if(cur_val <= result[k]) {
+                 result[k] = cur_val;
+                 result_index_a_begin[k] = i;
+               }
+             } else {
+               result[k] = std::min(result[k], cur_val);
+             }
+           }
+         }
+       }
+
+       template<bool WITH_INDEX, typename VALUE_TYPE, typename OUTPUT_ITERATOR_INDEX>
+       bool min_conv_naive_dispatch(
+           const VALUE_TYPE* a, const std::size_t a_size, const VALUE_TYPE* b, const std::size_t b_size,
+           VALUE_TYPE* result, const std::size_t k_begin, const std::size_t k_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+       {
+         // lane indices are computed in 32 bit arithmetic, optimal indices are stored in VALUE_TYPE.
+         if(a_size + b_size >= std::size_t(std::numeric_limits<std::int32_t>::max())) { return false; }
+         if(WITH_INDEX && a_size >= (std::size_t(1) << std::numeric_limits<VALUE_TYPE>::digits)) { return false; }
+
+         switch(active_simd_level()) {
+           case simd_level::avx512:
+             min_conv_naive_simd<avx512_kernel<VALUE_TYPE>, WITH_INDEX>(a, a_size, b, b_size, result, k_begin, k_end, result_index_a_begin);
+             return true;
+           case simd_level::avx2:
+             min_conv_naive_simd<avx2_kernel<VALUE_TYPE>, WITH_INDEX>(a, a_size, b, b_size, result, k_begin, k_end, result_index_a_begin);
+             return true;
+           default:
+             return false;
+         }
+       }
+
+#endif // TROPICAL_CONVOLUTION_X86_SIMD
+
+       template<bool WITH_INDEX, typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+       bool min_conv_naive_simd(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, const std::size_t k_begin, const std::size_t k_end, OUTPUT_ITERATOR_INDEX result_index_a_begin, std::true_type)
+       {
+#ifdef TROPICAL_CONVOLUTION_X86_SIMD
+         const std::size_t a_size = std::distance(a_begin, a_end);
+         const std::size_t b_size = std::distance(b_begin, b_end);
+         if(k_begin == k_end) { return true; }
+         return min_conv_naive_dispatch<WITH_INDEX>(&*a_begin, a_size, &*b_begin, b_size, &*result_begin, k_begin, k_end, result_index_a_begin);
+#else
+         return false;
+#endif
+       }
+
+       template<bool WITH_INDEX, typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+       bool min_conv_naive_simd(
+           INPUT_ITERATOR_1, INPUT_ITERATOR_1, INPUT_ITERATOR_2, INPUT_ITERATOR_2,
+           OUTPUT_ITERATOR_VAL, const std::size_t, const std::size_t, OUTPUT_ITERATOR_INDEX, std::false_type)
+       {
+         return false;
+       }
+
+       // run the vectorized kernel on the outputs [k_begin, k_end) if iterators and value type allow it and the host supports it. Return false if the generic version must be used.
+       template<bool WITH_INDEX, typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR_VAL, typename OUTPUT_ITERATOR_INDEX>
+       bool min_conv_naive_simd(
+           INPUT_ITERATOR_1 a_begin, INPUT_ITERATOR_1 a_end, INPUT_ITERATOR_2 b_begin, INPUT_ITERATOR_2 b_end,
+           OUTPUT_ITERATOR_VAL result_begin, const std::size_t k_begin, const std::size_t k_end, OUTPUT_ITERATOR_INDEX result_index_a_begin)
+       {
+         using eligible = std::integral_constant<bool, is_simd_eligible<INPUT_ITERATOR_1, INPUT_ITERATOR_2, OUTPUT_ITERATOR_VAL>::value>;
+         return min_conv_naive_simd<WITH_INDEX>(a_begin, a_end, b_begin, b_end, result_begin, k_begin, k_end, result_index_a_begin, eligible());
+       }
+
+  } // end namespace detail
+
+  // instruction set used by the vectorized naive min convolution. Defaults to the best one supported by the host.
+  inline simd_level get_simd_level()
+  {
+    return detail::active_simd_level();
+  }
+
+  // restrict the instruction set, e.g. for testing or benchmarking. Levels not supported by the host are clamped to the detected one.
+  inline void set_simd_level(const simd_level level)
+  {
+    detail::active_simd_level() = std::min(level, detail::detect_simd_level());
+  }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_SIMD_HXX
@@ -1,8 +1,18 @@
 #include "tropical_convolution.hxx"
+#include "tropical_convolution_batch.hxx"
+#include "tropical_convolution_parallel.hxx"
+#include "tropical_convolution_calibration.hxx"
+#include "tropical_convolution_chain.hxx"
+#include "tropical_convolution_approx.hxx"
 #include <stdexcept>
 #include <vector>
 #include <algorithm>
+#include <deque>
 #include <random>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <cstdio>
 
 inline void
 test(const bool& pred)
@@ -42,6 +52,548 @@ void test_naive_Bussieck(const VEC1 a, const VEC2 b, const std::size_t result_si
   }
 }
 
+// test whether the vectorized naive implementation returns the same values and indices as the generic one for every instruction set available
+template<typename VALUE_TYPE>
+void test_simd(const std::vector<VALUE_TYPE>& a, const std::vector<VALUE_TYPE>& b, const std::size_t result_size)
+{
+  using tropical_convolution::simd_level;
+  const auto level = tropical_convolution::get_simd_level();
+
+  // std::deque iterators are not contiguous, hence the generic implementation is used
+  const std::deque<VALUE_TYPE> a_generic(a.begin(), a.end());
+  std::vector<VALUE_TYPE> result_generic(result_size);
+  std::vector<std::size_t> result_idx_generic(result_size);
+  tropical_convolution::min_conv_naive(a_generic.begin(), a_generic.end(), b.begin(), b.end(), result_generic.begin(), result_generic.end(), result_idx_generic.begin());
+
+  for(const auto l : {simd_level::none, simd_level::avx2, simd_level::avx512}) {
+    if(l > level) { continue; }
+    tropical_convolution::set_simd_level(l);
+    std::vector<VALUE_TYPE> result(result_size);
+    std::vector<std::size_t> result_idx(result_size);
+    tropical_convolution::min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end());
+    test(result == result_generic);
+    tropical_convolution::min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin());
+    test(result == result_generic);
+    test(result_idx == result_idx_generic);
+  }
+  tropical_convolution::set_simd_level(level);
+}
+
+template<typename VALUE_TYPE, typename DISTRIBUTION>
+void test_simd_random(DISTRIBUTION dis)
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_int(2, 200);
+  for(auto run=0; run<200; ++run) {
+    const auto a_size = dis_int(gen);
+    const auto b_size = dis_int(gen);
+    std::uniform_int_distribution<> dis_result_size(1, a_size+b_size-1);
+    const auto result_size = dis_result_size(gen);
+
+    std::vector<VALUE_TYPE> a(a_size);
+    for(auto& x : a) { x = dis(gen); }
+    std::vector<VALUE_TYPE> b(b_size);
+    for(auto& x : b) { x = dis(gen); }
+
+    test_simd(a, b, result_size);
+  }
+}
+
+// test linear time algorithms for convex and concave input against the naive implementation
+template<typename CONV>
+void test_structured(const std::vector<double>& a, const std::vector<double>& b, const std::size_t result_size, CONV conv)
+{
+  std::vector<double> result_naive(result_size);
+  std::vector<double> result(result_size);
+  std::vector<std::size_t> result_idx(result_size);
+  tropical_convolution::min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result_naive.begin(), result_naive.end());
+  conv(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin());
+  test(result == result_naive);
+  for(auto i=0; i<result.size(); ++i) {
+    test(result_idx[i] < a.size() && i - result_idx[i] < b.size());
+    test(a[result_idx[i]] + b[i - result_idx[i]] == result[i]);
+  }
+  tropical_convolution::min_conv(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end());
+  test(result == result_naive);
+}
+
+// integer valued, so that all sums are exact
+std::vector<double> random_convex(std::mt19937& gen, const std::size_t size, const bool concave)
+{
+  std::uniform_int_distribution<> dis_slope(-20, 20);
+  std::vector<int> slopes(size-1);
+  for(auto& s : slopes) { s = dis_slope(gen); }
+  std::sort(slopes.begin(), slopes.end());
+  if(concave) { std::reverse(slopes.begin(), slopes.end()); }
+  std::vector<double> x(size, dis_slope(gen));
+  for(auto i=1; i<size; ++i) { x[i] = x[i-1] + slopes[i-1]; }
+  return x;
+}
+
+// quadratic penalty stored as float, not exactly convex after rounding for large sizes
+void test_nearly_convex()
+{
+  const std::size_t size = 20000;
+  const std::size_t result_size = 3000;
+  std::vector<float> a(size), b(size);
+  for(std::size_t i=0; i<size; ++i) {
+    a[i] = 0.37f * (float(i) - size/2) * (float(i) - size/2) / size;
+    b[i] = 0.21f * (float(i) - size/3) * (float(i) - size/3) / size + 1.0f;
+  }
+  std::vector<double> slopes;
+  test(!tropical_convolution::detail::is_convex(a.begin(), a.end()) && tropical_convolution::detail::nearly_convex_slopes(a.begin(), a.end(), slopes));
+
+  std::vector<float> result_naive(result_size), result(result_size);
+  std::vector<std::size_t> result_idx(result_size);
+  tropical_convolution::min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result_naive.begin(), result_naive.end());
+  test(tropical_convolution::detail::min_conv_structured(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), false));
+  const double max_error = 2.0 * tropical_convolution::min_conv_convex_tolerance * std::numeric_limits<float>::epsilon() * std::max(a.front(), b.back());
+  for(std::size_t k=0; k<result_size; ++k) {
+    test(a[result_idx[k]] + b[k - result_idx[k]] == result[k]);
+    test(result[k] >= result_naive[k] && result[k] <= result_naive[k] + max_error);
+  }
+
+  // not convex beyond rounding
+  a[size/2] += 1.0f;
+  test(!tropical_convolution::detail::nearly_convex_slopes(a.begin(), a.end(), slopes));
+}
+
+// test whether batched computation agrees with individual calls to min_conv
+void test_batch(const std::size_t nr_threads)
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_int(2, 400);
+  std::uniform_real_distribution<> dis_real(1.0, 2.0);
+
+  const std::size_t nr_problems = 300;
+  std::vector<std::vector<double>> a(nr_problems), b(nr_problems), result(nr_problems);
+  std::vector<std::vector<std::size_t>> result_idx(nr_problems);
+  for(std::size_t p=0; p<nr_problems; ++p) {
+    a[p].resize(dis_int(gen));
+    b[p].resize(dis_int(gen));
+    for(auto& x : a[p]) { x = dis_real(gen); }
+    for(auto& x : b[p]) { x = dis_real(gen); }
+    std::uniform_int_distribution<> dis_result_size(1, a[p].size()+b[p].size()-1);
+    result[p].resize(dis_result_size(gen));
+    result_idx[p].resize(result[p].size());
+  }
+
+  tropical_convolution::thread_pool pool(nr_threads);
+  tropical_convolution::min_conv_batch(a.begin(), a.end(), b.begin(), result.begin(), pool);
+  for(std::size_t p=0; p<nr_problems; ++p) {
+    std::vector<double> expected(result[p].size());
+    tropical_convolution::min_conv(a[p].begin(), a[p].end(), b[p].begin(), b[p].end(), expected.begin(), expected.end());
+    test(result[p] == expected);
+  }
+
+  // spans into contiguous storage
+  std::vector<tropical_convolution::span<const double>> a_span, b_span;
+  std::vector<tropical_convolution::span<double>> result_span;
+  std::vector<double> storage;
+  for(std::size_t p=0; p<nr_problems; ++p) { storage.resize(storage.size() + result[p].size()); }
+  for(std::size_t p=0, offset=0; p<nr_problems; offset+=result[p].size(), ++p) {
+    a_span.emplace_back(a[p].data(), a[p].size());
+    b_span.emplace_back(b[p].data(), b[p].size());
+    result_span.emplace_back(storage.data() + offset, result[p].size());
+  }
+  tropical_convolution::min_conv_batch(a_span.begin(), a_span.end(), b_span.begin(), result_span.begin(), result_idx.begin(), pool);
+  for(std::size_t p=0; p<nr_problems; ++p) {
+    for(std::size_t k=0; k<result[p].size(); ++k) {
+      test(result_span[p][k] == result[p][k]);
+      test(a[p][result_idx[p][k]] + b[p][k - result_idx[p][k]] == result[p][k]);
+    }
+  }
+}
+
+// test whether prepared operands and a reused workspace give the same results as a plain call
+void test_prepared()
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_int(2, 300);
+  std::uniform_real_distribution<> dis_real(1.0, 2.0);
+
+  tropical_convolution::min_conv_workspace<double> workspace;
+  for(auto run=0; run<20; ++run) {
+    std::vector<double> b(dis_int(gen));
+    for(auto& x : b) { x = dis_real(gen); }
+    const tropical_convolution::prepared_operand<double> b_prepared(b.begin(), b.end());
+    test(b_prepared.size() == b.size() && std::equal(b.begin(), b.end(), b_prepared.begin()));
+
+    for(auto k=0; k<10; ++k) {
+      std::vector<double> a(dis_int(gen));
+      for(auto& x : a) { x = dis_real(gen); }
+      const tropical_convolution::prepared_operand<double> a_prepared(a.begin(), a.end());
+      std::uniform_int_distribution<> dis_result_size(1, a.size()+b.size()-1);
+      const std::size_t result_size = dis_result_size(gen);
+
+      std::vector<double> expected(result_size), result(result_size);
+      std::vector<std::size_t> expected_idx(result_size), result_idx(result_size);
+      tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), expected.end(), expected_idx.begin());
+
+      tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), workspace);
+      test(result == expected && result_idx == expected_idx);
+      tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b_prepared, result.begin(), result.end(), result_idx.begin(), workspace);
+      test(result == expected && result_idx == expected_idx);
+      tropical_convolution::min_conv_Bussieck_et_al(a_prepared, b_prepared, result.begin(), result.end(), result_idx.begin(), workspace);
+      test(result == expected && result_idx == expected_idx);
+      tropical_convolution::min_conv_Bussieck_et_al(a_prepared, b_prepared, result.begin(), result.end(), workspace);
+      test(result == expected);
+
+      std::vector<double> expected_min_conv(result_size);
+      tropical_convolution::min_conv(a.begin(), a.end(), b.begin(), b.end(), expected_min_conv.begin(), expected_min_conv.end());
+      tropical_convolution::min_conv(a.begin(), a.end(), b_prepared, result.begin(), result.end(), workspace);
+      test(result == expected_min_conv);
+      tropical_convolution::min_conv(a.begin(), a.end(), b_prepared, result.begin(), result.end(), result_idx.begin(), workspace);
+      test(result == expected_min_conv);
+    }
+  }
+}
+
+// test whether parallel computation of a single convolution agrees bit for bit with the serial one
+void test_parallel(const std::size_t nr_threads)
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_int(2, 3000);
+  std::uniform_int_distribution<> dis_val(-20, 20); // provoke ties
+  tropical_convolution::thread_pool pool(nr_threads);
+  tropical_convolution::min_conv_workspace<double> workspace;
+
+  for(auto run=0; run<20; ++run) {
+    std::vector<double> a(dis_int(gen)), b(dis_int(gen));
+    for(auto& x : a) { x = dis_val(gen); }
+    for(auto& x : b) { x = dis_val(gen); }
+    std::uniform_int_distribution<> dis_result_size(1, a.size()+b.size()-1);
+    const std::size_t result_size = dis_result_size(gen);
+
+    std::vector<double> expected(result_size), result(result_size);
+    std::vector<std::size_t> expected_idx(result_size), result_idx(result_size);
+
+    tropical_convolution::min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), expected.end(), expected_idx.begin());
+    tropical_convolution::min_conv_naive_parallel(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), pool);
+    test(result == expected && result_idx == expected_idx);
+    tropical_convolution::min_conv_naive_parallel(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), pool);
+    test(result == expected);
+
+    // generic loops
+    const std::deque<double> a_deque(a.begin(), a.end());
+    tropical_convolution::min_conv_naive_parallel(a_deque.begin(), a_deque.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), pool);
+    test(result == expected && result_idx == expected_idx);
+
+    tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), expected.end(), expected_idx.begin());
+    tropical_convolution::min_conv_Bussieck_et_al_parallel(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), workspace, pool);
+    test(result == expected && result_idx == expected_idx);
+    tropical_convolution::min_conv_Bussieck_et_al_parallel(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), workspace, pool);
+    test(result == expected);
+
+    tropical_convolution::min_conv(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), expected.end(), expected_idx.begin());
+    tropical_convolution::min_conv_parallel(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), pool);
+    test(result == expected && result_idx == expected_idx);
+  }
+}
+
+// test integer costs, for which the method of Bussieck et al uses a radix queue. Few distinct values provoke ties, wide values exercise all buckets.
+template<typename VALUE_TYPE>
+void test_integer(const VALUE_TYPE min_val, const VALUE_TYPE max_val)
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_int(2, 300);
+  std::uniform_int_distribution<VALUE_TYPE> dis_val(min_val, max_val);
+  tropical_convolution::min_conv_workspace<VALUE_TYPE> workspace;
+
+  for(auto run=0; run<300; ++run) {
+    std::vector<VALUE_TYPE> a(dis_int(gen)), b(dis_int(gen));
+    for(auto& x : a) { x = dis_val(gen); }
+    for(auto& x : b) { x = dis_val(gen); }
+    std::uniform_int_distribution<> dis_result_size(1, a.size()+b.size()-1);
+    const std::size_t result_size = dis_result_size(gen);
+
+    std::vector<VALUE_TYPE> result_naive(result_size), result(result_size);
+    std::vector<std::size_t> result_idx(result_size);
+    tropical_convolution::min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result_naive.begin(), result_naive.end());
+    tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), workspace);
+    test(result == result_naive);
+    for(std::size_t k=0; k<result_size; ++k) {
+      test(result_idx[k] < a.size() && k - result_idx[k] < b.size());
+      test(a[result_idx[k]] + b[k - result_idx[k]] == result[k]);
+      test(result[k] == tropical_convolution::min_sum(a.begin(), a.end(), b.begin(), b.end(), k));
+    }
+  }
+}
+
+// infinite input values must not be mistaken for unassigned outputs
+void test_infinite_input()
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_int(2, 300);
+  std::uniform_real_distribution<> dis_real(1.0, 2.0);
+  std::bernoulli_distribution dis_inf(0.5);
+
+  for(auto run=0; run<300; ++run) {
+    std::vector<double> a(dis_int(gen)), b(dis_int(gen));
+    for(auto& x : a) { x = dis_inf(gen) ? std::numeric_limits<double>::infinity() : dis_real(gen); }
+    for(auto& x : b) { x = dis_inf(gen) ? std::numeric_limits<double>::infinity() : dis_real(gen); }
+    std::uniform_int_distribution<> dis_result_size(1, a.size()+b.size()-1);
+    const std::size_t result_size = dis_result_size(gen);
+
+    std::vector<double> result_naive(result_size), result(result_size);
+    tropical_convolution::min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result_naive.begin(), result_naive.end());
+    tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end());
+    test(result == result_naive);
+  }
+}
+
+// test that counting statistics does not change results and that the counters are consistent
+void test_statistics()
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_int(2, 300);
+  std::uniform_real_distribution<> dis_real(1.0, 2.0);
+  tropical_convolution::min_conv_workspace<double> workspace;
+
+  for(auto run=0; run<100; ++run) {
+    std::vector<double> a(dis_int(gen)), b(dis_int(gen));
+    for(auto& x : a) { x = dis_real(gen); }
+    for(auto& x : b) { x = dis_real(gen); }
+    std::uniform_int_distribution<> dis_result_size(1, a.size()+b.size()-1);
+    const std::size_t result_size = dis_result_size(gen);
+
+    std::vector<double> expected(result_size), result(result_size);
+    std::vector<std::size_t> expected_idx(result_size), result_idx(result_size);
+    tropical_convolution::min_conv_statistics statistics;
+    tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), expected.end(), expected_idx.begin(), workspace);
+    tropical_convolution::min_conv_Bussieck_et_al(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), workspace, statistics);
+    test(result == expected && result_idx == expected_idx);
+    test(statistics.calls == 1 && statistics.outputs == result_size);
+    test(statistics.pops <= statistics.pushes && statistics.max_queue_size <= statistics.pushes);
+    test(statistics.fallbacks <= 1 && statistics.open_at_fallback <= result_size);
+    test(statistics.fallbacks == 1 || statistics.open_at_fallback == 0);
+    test(statistics.fallbacks == 0 || statistics.pops_at_fallback == statistics.pops);
+  }
+}
+
+// test calibration, profile files and that min_conv stays correct with arbitrary parameters
+void test_tuning()
+{
+  using namespace tropical_convolution;
+  const auto level = get_simd_level();
+
+  min_conv_calibrate<float>(2048);
+  for(std::size_t r=0; r<min_conv_nr_ratio_buckets; ++r) {
+    const auto p = get_min_conv_parameters<float>(level, r);
+    test((p.naive_threshold >= 64 && p.naive_threshold <= 2048) || p.naive_threshold == min_conv_always_naive);
+    test(p.fallback_ratio > 0.0 && p.fallback_ratio < 1.0);
+  }
+
+  min_conv_parameters p;
+  p.naive_threshold = 12;
+  p.fallback_ratio = 0.5;
+  set_min_conv_parameters<double>(simd_level::none, 3, p);
+  const std::string filename = "tropical_convolution_test.profile";
+  save_min_conv_profile(filename);
+  reset_min_conv_parameters();
+  test(get_min_conv_parameters<double>(simd_level::none, 3).naive_threshold == 0);
+  test(load_min_conv_profile(filename));
+  std::remove(filename.c_str());
+  test(get_min_conv_parameters<double>(simd_level::none, 3).naive_threshold == 12);
+  test(get_min_conv_parameters<double>(simd_level::none, 3).fallback_ratio == 0.5);
+  test(get_min_conv_parameters<float>(level, 0).naive_threshold >= 64);
+  test(!load_min_conv_profile("does_not_exist.profile"));
+
+  bool thrown = false;
+  try {
+    std::istringstream in("double none 7 100 0.1\n");
+    detail::tuning_table table;
+    detail::read_profile(in, table);
+  } catch(const std::runtime_error&) {
+    thrown = true;
+  }
+  test(thrown);
+
+  // the profile named by TROPICAL_CONVOLUTION_PROFILE is read skipping bad lines
+  {
+    std::istringstream in("garbage\ndouble none 7 100 0.1\nquad none 0 100 0.1\ndouble avx2 1 300 0.2\n");
+    detail::tuning_table table;
+    detail::read_profile(in, table, true);
+    test(table.entries[1][1][1].naive_threshold == 300 && table.entries[1][1][1].fallback_ratio == 0.2);
+  }
+
+  // extreme parameters only change speed, not results
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<> dis_real(1.0, 2.0);
+  for(const double ratio : {0.001, 1000.0}) {
+    for(std::size_t l=0; l<3; ++l) {
+      for(std::size_t r=0; r<min_conv_nr_ratio_buckets; ++r) {
+        set_min_conv_parameters<double>(simd_level(l), r, {1, ratio});
+      }
+    }
+    std::vector<double> a(300), b(50);
+    for(auto& x : a) { x = dis_real(gen); }
+    for(auto& x : b) { x = dis_real(gen); }
+    std::vector<double> result(a.size()+b.size()-1), result_naive(result.size());
+    min_conv(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end());
+    min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), result_naive.begin(), result_naive.end());
+    test(result == result_naive);
+  }
+  reset_min_conv_parameters();
+}
+
+// test min_conv_chain against convolving the operands one after another, and the recovered indices into the operands
+void test_chain(const std::size_t nr_threads)
+{
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_nr_operands(1, 9);
+  std::uniform_int_distribution<> dis_size(1, 400);
+  std::uniform_int_distribution<> dis_val(-20, 20); // integral values, the sums do not depend on the order of summation
+  tropical_convolution::thread_pool pool(nr_threads);
+
+  for(auto run=0; run<30; ++run) {
+    std::vector<std::vector<double>> operands(dis_nr_operands(gen));
+    for(auto& o : operands) {
+      o.resize(dis_size(gen));
+      for(auto& x : o) { x = dis_val(gen); }
+    }
+
+    std::vector<double> expected = operands[0];
+    for(std::size_t m=1; m<operands.size(); ++m) {
+      std::vector<double> c(expected.size() + operands[m].size() - 1, std::numeric_limits<double>::infinity());
+      for(std::size_t i=0; i<expected.size(); ++i) {
+        for(std::size_t j=0; j<operands[m].size(); ++j) {
+          c[i+j] = std::min(c[i+j], expected[i] + operands[m][j]);
+        }
+      }
+      expected = c;
+    }
+    std::uniform_int_distribution<> dis_result_size(1, expected.size());
+    expected.resize(dis_result_size(gen));
+
+    std::vector<double> result(expected.size());
+    tropical_convolution::min_conv_chain(operands.begin(), operands.end(), result.begin(), result.end(), pool);
+    test(result == expected);
+
+    tropical_convolution::min_conv_chain_arg_min arg_min;
+    std::fill(result.begin(), result.end(), 0.0);
+    tropical_convolution::min_conv_chain(operands.begin(), operands.end(), result.begin(), result.end(), arg_min, pool);
+    test(result == expected);
+    std::vector<std::size_t> split(operands.size());
+    for(std::size_t k=0; k<result.size(); ++k) {
+      arg_min.split(k, split.begin());
+      std::size_t index_sum = 0;
+      double value = 0.0;
+      for(std::size_t m=0; m<operands.size(); ++m) {
+        test(split[m] < operands[m].size());
+        index_sum += split[m];
+        value += operands[m][split[m]];
+      }
+      test(index_sum == k && value == result[k]);
+    }
+
+    // spans into contiguous storage
+    std::vector<double> storage;
+    for(const auto& o : operands) { storage.insert(storage.end(), o.begin(), o.end()); }
+    std::vector<tropical_convolution::span<const double>> spans;
+    std::size_t offset = 0;
+    for(const auto& o : operands) {
+      spans.push_back({storage.data() + offset, o.size()});
+      offset += o.size();
+    }
+    std::fill(result.begin(), result.end(), 0.0);
+    tropical_convolution::min_conv_chain(spans.begin(), spans.end(), result.begin(), result.end(), pool);
+    test(result == expected);
+  }
+}
+
+// test the error bounds of min_conv_approx and min_conv_approx_additive against min_conv_naive
+template<typename VALUE_TYPE>
+void test_approx()
+{
+  using namespace tropical_convolution;
+  // approximate also small inputs
+  for(std::size_t l=0; l<3; ++l) {
+    for(std::size_t r=0; r<min_conv_nr_ratio_buckets; ++r) {
+      set_min_conv_parameters<VALUE_TYPE>(simd_level(l), r, {1, 0.0});
+    }
+  }
+  const double tolerance = 4 * std::numeric_limits<VALUE_TYPE>::epsilon(); // rounding of the sums
+  const VALUE_TYPE inf = std::numeric_limits<VALUE_TYPE>::infinity();
+
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<> dis_size(2, 2000);
+  std::uniform_real_distribution<> dis_real(0.0, 1.0);
+  for(auto run=0; run<40; ++run) {
+    // uniform, heavy tailed, nearly constant, sorted with infinite entries
+    auto generate = [&](std::vector<VALUE_TYPE>& x) {
+      x.resize(dis_size(gen));
+      for(auto& v : x) {
+        const double u = dis_real(gen);
+        switch(run % 4) {
+          case 0: v = 1000.0 * u; break;
+          case 1: v = std::min(1e6, 1.0 / (1.0 - u)); break;
+          case 2: v = 1000.0 + 1e-3 * u; break;
+          case 3: v = u < 0.2 ? inf : VALUE_TYPE(1000.0 * u); break;
+        }
+      }
+      if(run % 4 == 3) { std::sort(x.begin(), x.end()); }
+    };
+    std::vector<VALUE_TYPE> a, b;
+    generate(a);
+    generate(b);
+    std::uniform_int_distribution<> dis_result_size(1, a.size()+b.size()-1);
+    const std::size_t result_size = dis_result_size(gen);
+
+    std::vector<VALUE_TYPE> expected(result_size), result(result_size), result_val(result_size);
+    std::vector<std::size_t> result_idx(result_size);
+    min_conv_naive(a.begin(), a.end(), b.begin(), b.end(), expected.begin(), expected.end());
+
+    for(const double epsilon : {0.0, 0.01, 0.1}) {
+      min_conv_approx(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), epsilon);
+      min_conv_approx(a.begin(), a.end(), b.begin(), b.end(), result_val.begin(), result_val.end(), epsilon);
+      test(result_val == result);
+      if(epsilon == 0.0) { test(result == expected); }
+      for(std::size_t k=0; k<result_size; ++k) {
+        test(result[k] >= expected[k] && result[k] <= (1.0 + epsilon) * (1.0 + tolerance) * expected[k]);
+        test(result_idx[k] <= k && k - result_idx[k] < b.size() && result[k] == a[result_idx[k]] + b[k - result_idx[k]]);
+      }
+    }
+
+    for(const double delta : {0.0, 0.5, 10.0}) {
+      min_conv_approx_additive(a.begin(), a.end(), b.begin(), b.end(), result.begin(), result.end(), result_idx.begin(), delta);
+      min_conv_approx_additive(a.begin(), a.end(), b.begin(), b.end(), result_val.begin(), result_val.end(), delta);
+      test(result_val == result);
+      if(delta == 0.0) { test(result == expected); }
+      for(std::size_t k=0; k<result_size; ++k) {
+        test(result[k] >= expected[k] && result[k] <= expected[k] + delta + tolerance * expected[k]);
+        test(result_idx[k] <= k && k - result_idx[k] < b.size() && result[k] == a[result_idx[k]] + b[k - result_idx[k]]);
+      }
+    }
+  }
+  reset_min_conv_parameters();
+}
+
+// test that the sample of min_conv_approx predicts the method: the naive kernel for sorted input, where no output is settled early, and approximation for nearly constant input
+template<typename VALUE_TYPE>
+void test_approx_method()
+{
+  using namespace tropical_convolution;
+  std::mt19937 gen(1);
+  std::uniform_real_distribution<> dis_real(0.0, 1.0);
+  const std::size_t n = 2000;
+  std::vector<VALUE_TYPE> sorted(n), near_constant(n);
+  for(auto& v : sorted) { v = 1000.0 * dis_real(gen); }
+  std::sort(sorted.begin(), sorted.end());
+  for(auto& v : near_constant) { v = 1000.0 + 1e-3 * dis_real(gen); }
+
+  for(const bool with_bussieck : {false, true}) {
+    double average_pairs;
+    const auto idx_sorted = detail::sort_indices(sorted.begin(), sorted.end());
+    test(detail::min_conv_approx_method(sorted.begin(), sorted.end(), idx_sorted, sorted.begin(), sorted.end(), idx_sorted,
+          2*n-1, detail::relative_tolerance{0.01}, with_bussieck, average_pairs) == detail::approx_method::naive);
+    test(average_pairs >= 1.0 && average_pairs <= n);
+    const auto idx_near_constant = detail::sort_indices(near_constant.begin(), near_constant.end());
+    test(detail::min_conv_approx_method(near_constant.begin(), near_constant.end(), idx_near_constant, near_constant.begin(), near_constant.end(), idx_near_constant,
+          2*n-1, detail::relative_tolerance{0.01}, with_bussieck, average_pairs) == detail::approx_method::approximate);
+  }
+}
+
 // test whether naive implementation and Bussieck et al algorithms return same results
 int main()
 {
@@ -84,5 +636,96 @@ int main()
 
     } 
   }
-}
 
+  // vectorized naive implementation, small integer range to provoke ties
+  {
+    test_simd_random<double>(std::uniform_real_distribution<double>(1.0, 2.0));
+    test_simd_random<float>(std::uniform_real_distribution<float>(1.0, 2.0));
+    test_simd_random<std::int32_t>(std::uniform_int_distribution<std::int32_t>(-5, 5));
+  }
+
+  // convex and concave input
+  {
+    std::mt19937 gen(1);
+    std::uniform_int_distribution<> dis_int(2, 300);
+    std::uniform_int_distribution<> dis_val(-50, 50);
+    auto convex = [](auto... args) { tropical_convolution::min_conv_convex(args...); };
+    auto concave = [](auto... args) { tropical_convolution::min_conv_concave(args...); };
+    for(auto run=0; run<300; ++run) {
+      const auto a_size = dis_int(gen);
+      const auto b_size = dis_int(gen);
+      std::uniform_int_distribution<> dis_result_size(1, a_size+b_size-1);
+      const auto result_size = dis_result_size(gen);
+
+      std::vector<double> arbitrary_a(a_size);
+      for(auto& x : arbitrary_a) { x = dis_val(gen); }
+      std::vector<double> arbitrary_b(b_size);
+      for(auto& x : arbitrary_b) { x = dis_val(gen); }
+
+      test_structured(random_convex(gen, a_size, false), random_convex(gen, b_size, false), result_size, convex);
+      test_structured(arbitrary_a, random_convex(gen, b_size, false), result_size, convex);
+      test_structured(random_convex(gen, a_size, false), arbitrary_b, result_size, convex);
+      test_structured(random_convex(gen, a_size, true), random_convex(gen, b_size, true), result_size, concave);
+    }
+    test_nearly_convex();
+  }
+
+  // prepared operands and workspace reuse
+  {
+    test_prepared();
+  }
+
+  // integer costs and infinite input
+  {
+    test_integer<std::int32_t>(-5, 5);
+    test_integer<std::int32_t>(-1000000, 1000000);
+    test_integer<std::int64_t>(-(std::int64_t(1) << 40), std::int64_t(1) << 40);
+    test_integer<std::uint32_t>(0, 1000);
+    test_infinite_input();
+    const std::int32_t int_max = std::numeric_limits<std::int32_t>::max();
+    const std::vector<std::int32_t> half_max {0, int_max/2, -int_max/2}, one_max {0, int_max}, one_min {0, -int_max-1};
+    const std::vector<std::uint32_t> unsigned_max {0, std::numeric_limits<std::uint32_t>::max()}, unsigned_zero {0, 0};
+    test(tropical_convolution::detail::sums_fit(half_max.begin(), half_max.end(), half_max.begin(), half_max.end()));
+    test(!tropical_convolution::detail::sums_fit(one_max.begin(), one_max.end(), half_max.begin(), half_max.end()));
+    test(!tropical_convolution::detail::sums_fit(half_max.begin(), half_max.end(), one_min.begin(), one_min.end()));
+    test(tropical_convolution::detail::sums_fit(one_max.begin(), one_max.end(), one_min.begin(), one_min.end()));
+    test(tropical_convolution::detail::sums_fit(unsigned_max.begin(), unsigned_max.end(), unsigned_zero.begin(), unsigned_zero.end()));
+    test(!tropical_convolution::detail::sums_fit(unsigned_max.begin(), unsigned_max.end(), unsigned_max.begin(), unsigned_max.end()));
+  }
+
+  // batched computation
+  {
+    test_batch(1);
+    test_batch(3);
+  }
+
+  // parallel computation of a single convolution
+  {
+    test_parallel(1);
+    test_parallel(3);
+  }
+
+  // statistics of Bussieck et al
+  {
+    test_statistics();
+  }
+
+  // tuned parameters
+  {
+    test_tuning();
+  }
+
+  // chains of convolutions
+  {
+    test_chain(1);
+    test_chain(3);
+  }
+
+  // approximate convolution
+  {
+    test_approx<float>();
+    test_approx<double>();
+    test_approx_method<float>();
+    test_approx_method<double>();
+  }
+}
@@ -0,0 +1,156 @@
+#ifndef TROPICAL_CONVOLUTION_THREAD_POOL_HXX
+#define TROPICAL_CONVOLUTION_THREAD_POOL_HXX
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <exception>
+#include <algorithm>
+#include <cassert>
+
+// minimal work-stealing thread pool for running many independent convolutions.
+// Every worker owns a queue of task indices. It takes tasks from the front of its own queue and, once that is empty, steals from the back of the other queues.
+// The calling thread participates as worker 0, hence a pool of size 1 does not start any thread.
+
+namespace tropical_convolution {
+
+  class thread_pool {
+    public:
+      explicit thread_pool(const std::size_t nr_threads = std::max(1u, std::thread::hardware_concurrency()))
+        : queues_(std::max(std::size_t(1), nr_threads))
+      {
+        for(std::size_t w=1; w<queues_.size(); ++w) {
+          threads_.emplace_back([this,w]() { worker_loop(w); });
+        }
+      }
+
+      ~thread_pool()
+      {
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          stop_ = true;
+        }
+        job_cv_.notify_all();
+        for(auto& t : threads_) { t.join(); }
+      }
+
+      thread_pool(const thread_pool&) = delete;
+      thread_pool& operator=(const thread_pool&) = delete;
+
+      std::size_t size() const { return queues_.size(); }
+
+      // call f(task, worker) for every task in [0,nr_tasks) and wait until all have finished. worker < size() identifies the executing thread.
+      // Task t is initially queued at worker t % size(), so consecutive tasks are spread over all workers.
+      // The first exception thrown by a task is rethrown after all tasks have finished. Must not be called from within a task.
+      void run(const std::size_t nr_tasks, std::function<void(std::size_t, std::size_t)> f)
+      {
+        std::lock_guard<std::mutex> run_lock(run_mutex_);
+        for(std::size_t t=0; t<nr_tasks; ++t) {
+          queues_[t % queues_.size()].tasks.push_back(t);
+        }
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          job_ = std::move(f);
+          exception_ = nullptr;
+          busy_ = threads_.size();
+          ++generation_;
+        }
+        job_cv_.notify_all();
+
+        work(0);
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_cv_.wait(lock, [this]() { return busy_ == 0; });
+        job_ = nullptr;
+        if(exception_) { std::rethrow_exception(exception_); }
+      }
+
+    private:
+      struct task_queue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+      };
+
+      bool pop(const std::size_t worker, std::size_t& task)
+      {
+        {
+          auto& q = queues_[worker];
+          std::lock_guard<std::mutex> lock(q.mutex);
+          if(!q.tasks.empty()) {
+            task = q.tasks.front();
+            q.tasks.pop_front();
+            return true;
+          }
+        }
+        for(std::size_t k=1; k<queues_.size(); ++k) {
+          auto& q = queues_[(worker + k) % queues_.size()];
+          std::lock_guard<std::mutex> lock(q.mutex);
+          if(!q.tasks.empty()) {
+            task = q.tasks.back();
+            q.tasks.pop_back();
+            return true;
+          }
+        }
+        return false;
+      }
+
+      void work(const std::size_t worker)
+      {
+        std::size_t task;
+        while(pop(worker, task)) {
+          try {
+            job_(task, worker);
+          } catch(...) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(!exception_) { exception_ = std::current_exception(); }
+          }
+        }
+      }
+
+      void worker_loop(const std::size_t worker)
+      {
+        std::size_t seen_generation = 0;
+        while(true) {
+          {
+            std::unique_lock<std::mutex> lock(mutex_);
+            job_cv_.wait(lock, [&]() { return stop_ || generation_ != seen_generation; });
+            if(stop_) { return; }
+            seen_generation = generation_;
+          }
+          work(worker);
+          {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --busy_;
+          }
+          done_cv_.notify_one();
+        }
+      }
+
+      std::vector<task_queue> queues_;
+      std::vector<std::thread> threads_;
+
+      std::mutex run_mutex_; // serializes calls to run
+      std::mutex mutex_; // protects the members below
+      std::condition_variable job_cv_;
+      std::condition_variable done_cv_;
+      std::function<void(std::size_t, std::size_t)> job_;
+      std::exception_ptr exception_;
+      std::size_t busy_ = 0;
+      std::size_t generation_ = 0;
+      bool stop_ = false;
+  };
+
+  // pool shared by all calls that are not given one explicitly, sized to the number of hardware threads.
+  inline thread_pool& default_thread_pool()
+  {
+    static thread_pool pool;
+    return pool;
+  }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_THREAD_POOL_HXX
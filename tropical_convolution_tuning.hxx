@@ -0,0 +1,194 @@
+#ifndef TROPICAL_CONVOLUTION_TUNING_HXX
+#define TROPICAL_CONVOLUTION_TUNING_HXX
+
+#include "tropical_convolution_simd.hxx"
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <limits>
+#include <cassert>
+
+// parameters of the algorithm selection that depend on the machine: the result size above which min_conv uses the method of Bussieck et al instead of the naive one,
+// and the queue size relative to the unassigned outputs at which the method of Bussieck et al computes the remaining values explicitly.
+// They are kept per value type, instruction set of the naive kernel and ratio of the operand sizes. Untuned entries use the built in defaults.
+// The truncated fraction of the result is deliberately not a key: the threshold is compared with the number of computed outputs, i.e. the truncated length, which already
+// accounts for most of its effect, and a further dimension would multiply the calibration time and profile size. Calibration measures untruncated problems.
+// Tuned values are measured by min_conv_calibrate (tropical_convolution_calibration.hxx) and stored in a profile file,
+// which is loaded on first use when the environment variable TROPICAL_CONVOLUTION_PROFILE names it.
+
+namespace tropical_convolution {
+
+  // default for the fallback of the method of Bussieck et al.
+  static const double min_conv_fallback_ratio = 0.08; // 0.08 seems to be a good value based on preliminary experiments
+
+  // the ratio max(a_size,b_size)/min(a_size,b_size) is tuned separately in the ranges [1,2), [2,8), [8,32) and [32,inf).
+  static const std::size_t min_conv_nr_ratio_buckets = 4;
+
+  // naive threshold of entries where the naive method won at all sizes measured by min_conv_calibrate: min_conv then never uses the method of Bussieck et al.
+  static const std::size_t min_conv_always_naive = std::numeric_limits<std::size_t>::max();
+
+  // a value of zero means that the parameter is not tuned.
+  struct min_conv_parameters {
+    std::size_t naive_threshold = 0;
+    double fallback_ratio = 0.0;
+  };
+
+  namespace detail {
+
+       // value types with tuned parameters, -1 for all others.
+       template<typename VALUE_TYPE> struct tuning_type : std::integral_constant<int, -1> {};
+       template<> struct tuning_type<float> : std::integral_constant<int, 0> {};
+       template<> struct tuning_type<double> : std::integral_constant<int, 1> {};
+       template<> struct tuning_type<std::int32_t> : std::integral_constant<int, 2> {};
+       template<> struct tuning_type<std::int64_t> : std::integral_constant<int, 3> {};
+
+       static const std::size_t nr_tuning_types = 4;
+       static const std::size_t nr_simd_levels = 3;
+       static const char* const tuning_type_names[nr_tuning_types] = {"float", "double", "int32", "int64"};
+       static const char* const simd_level_names[nr_simd_levels] = {"none", "avx2", "avx512"};
+
+       inline std::size_t ratio_bucket(const std::size_t a_size, const std::size_t b_size)
+       {
+         const std::size_t ratio = std::max(a_size, b_size) / std::max(std::size_t(1), std::min(a_size, b_size));
+         return ratio < 2 ? 0 : ratio < 8 ? 1 : ratio < 32 ? 2 : 3;
+       }
+
+       // instruction set used by min_conv_naive for the given iterators.
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+       simd_level effective_simd_level()
+       {
+         return is_simd_eligible<INPUT_ITERATOR_1, INPUT_ITERATOR_2, OUTPUT_ITERATOR>::value ? active_simd_level() : simd_level::none;
+       }
+
+       struct tuning_table {
+         min_conv_parameters entries[nr_tuning_types][nr_simd_levels][min_conv_nr_ratio_buckets];
+       };
+
+       template<typename NAMES>
+       std::size_t tuning_name_index(const std::string& name, const NAMES& names, const std::size_t nr_names)
+       {
+         for(std::size_t i=0; i<nr_names; ++i) {
+           if(name == names[i]) { return i; }
+         }
+         throw std::runtime_error("unknown entry " + name + " in tropical convolution profile");
+       }
+
+       // one line per tuned entry: value type, instruction set, ratio bucket, naive threshold and fallback ratio. Lines starting with # are comments.
+       // Throw on malformed lines and unknown entries, or skip them if skip_malformed is set.
+       inline void read_profile(std::istream& in, tuning_table& table, const bool skip_malformed = false)
+       {
+         std::string line;
+         while(std::getline(in, line)) {
+           if(line.empty() || line[0] == '#') { continue; }
+           try {
+             std::istringstream ss(line);
+             std::string type, level;
+             std::size_t bucket;
+             min_conv_parameters p;
+             if(!(ss >> type >> level >> bucket >> p.naive_threshold >> p.fallback_ratio) || bucket >= min_conv_nr_ratio_buckets || p.fallback_ratio < 0.0) {
+               throw std::runtime_error("malformed line in tropical convolution profile: " + line);
+             }
+             table.entries[tuning_name_index(type, tuning_type_names, nr_tuning_types)][tuning_name_index(level, simd_level_names, nr_simd_levels)][bucket] = p;
+           } catch(const std::runtime_error&) {
+             if(!skip_malformed) { throw; }
+           }
+         }
+       }
+
+       inline void write_profile(std::ostream& out, const tuning_table& table)
+       {
+         out << "# tropical convolution profile: value type, simd level, ratio bucket, naive threshold, fallback ratio\n";
+         for(std::size_t t=0; t<nr_tuning_types; ++t) {
+           for(std::size_t l=0; l<nr_simd_levels; ++l) {
+             for(std::size_t r=0; r<min_conv_nr_ratio_buckets; ++r) {
+               const auto& p = table.entries[t][l][r];
+               if(p.naive_threshold > 0 || p.fallback_ratio > 0.0) {
+                 out << tuning_type_names[t] << " " << simd_level_names[l] << " " << r << " " << p.naive_threshold << " " << p.fallback_ratio << "\n";
+               }
+             }
+           }
+         }
+       }
+
+       // a bad profile must not make every min_conv throw, e.g. one written by a newer version with more entries. Such lines are ignored.
+       inline tuning_table initial_tuning_table()
+       {
+         tuning_table table;
+         const char* filename = std::getenv("TROPICAL_CONVOLUTION_PROFILE");
+         if(filename != nullptr) {
+           std::ifstream in(filename);
+           if(in) { read_profile(in, table, true); }
+         }
+         return table;
+       }
+
+       // parameters are read concurrently by all calls to min_conv, modify them only while no convolution is running.
+       inline tuning_table& tuning()
+       {
+         static tuning_table table = initial_tuning_table();
+         return table;
+       }
+
+       template<typename VALUE_TYPE>
+       const min_conv_parameters& tuned_parameters(const simd_level level, const std::size_t a_size, const std::size_t b_size)
+       {
+         static const min_conv_parameters untuned;
+         constexpr int t = tuning_type<VALUE_TYPE>::value;
+         return t < 0 ? untuned : tuning().entries[t][std::size_t(level)][ratio_bucket(a_size, b_size)];
+       }
+
+       template<typename INPUT_ITERATOR_1, typename INPUT_ITERATOR_2, typename OUTPUT_ITERATOR>
+       double fallback_ratio(const std::size_t a_size, const std::size_t b_size)
+       {
+         using VALUE_TYPE = typename std::iterator_traits<INPUT_ITERATOR_1>::value_type;
+         const auto& p = tuned_parameters<VALUE_TYPE>(effective_simd_level<INPUT_ITERATOR_1, INPUT_ITERATOR_2, OUTPUT_ITERATOR>(), a_size, b_size);
+         return p.fallback_ratio > 0.0 ? p.fallback_ratio : min_conv_fallback_ratio;
+       }
+
+  } // end namespace detail
+
+  template<typename VALUE_TYPE>
+  min_conv_parameters get_min_conv_parameters(const simd_level level, const std::size_t ratio_bucket)
+  {
+    static_assert(detail::tuning_type<VALUE_TYPE>::value >= 0, "parameters are tuned for float, double, int32_t and int64_t");
+    assert(ratio_bucket < min_conv_nr_ratio_buckets);
+    return detail::tuning().entries[detail::tuning_type<VALUE_TYPE>::value][std::size_t(level)][ratio_bucket];
+  }
+
+  template<typename VALUE_TYPE>
+  void set_min_conv_parameters(const simd_level level, const std::size_t ratio_bucket, const min_conv_parameters& p)
+  {
+    static_assert(detail::tuning_type<VALUE_TYPE>::value >= 0, "parameters are tuned for float, double, int32_t and int64_t");
+    assert(ratio_bucket < min_conv_nr_ratio_buckets);
+    detail::tuning().entries[detail::tuning_type<VALUE_TYPE>::value][std::size_t(level)][ratio_bucket] = p;
+  }
+
+  // reset all parameters to the built in defaults.
+  inline void reset_min_conv_parameters()
+  {
+    detail::tuning() = detail::tuning_table();
+  }
+
+  // load tuned parameters, entries not in the file keep their current value. Return false if the file cannot be opened, throw on malformed content.
+  inline bool load_min_conv_profile(const std::string& filename)
+  {
+    std::ifstream in(filename);
+    if(!in) { return false; }
+    detail::read_profile(in, detail::tuning());
+    return true;
+  }
+
+  inline void save_min_conv_profile(const std::string& filename)
+  {
+    std::ofstream out(filename);
+    detail::write_profile(out, detail::tuning());
+    if(!out) { throw std::runtime_error("could not write tropical convolution profile " + filename); }
+  }
+
+} // end namespace tropical_convolution
+
+#endif // TROPICAL_CONVOLUTION_TUNING_HXX